@@ -89,6 +89,8 @@ namespace
     int  insitu_on_restart;
     int  checkpoint_on_restart;
     bool checkpoint_files_output;
+    bool async_checkpoint;
+    int  incremental_checkpoint;
     int  compute_new_dt_on_regrid;
     bool precreateDirectories;
     bool prereadFAHeaders;
@@ -124,6 +126,8 @@ Amr::Initialize ()
     insitu_on_restart        = 0;
     checkpoint_on_restart    = 0;
     checkpoint_files_output  = true;
+    async_checkpoint         = false;
+    incremental_checkpoint   = 0;
     compute_new_dt_on_regrid = 0;
     precreateDirectories     = true;
     prereadFAHeaders         = true;
@@ -240,6 +244,7 @@ Amr::InitAmr ()
     last_plotfile          = 0;
     last_smallplotfile     = -1;
     last_checkpoint        = 0;
+    n_checkpoints          = 0;
     record_run_info        = false;
     record_grid_info       = false;
     file_name_digits       = 5;
@@ -731,6 +736,8 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    finishAsyncCheckPoint();
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -982,6 +989,29 @@ Amr::writePlotFileDoit (std::string const& pltfile, bool regular)
             for (int k(0); k <= finest_level; ++k) {
                 amr_level[k]->writePlotFilePost(pltfileTemp, HeaderFile);
             }
+            if (plotPreviews()) {
+                // The previews are made of the data writePlotFile has just
+                // written.  Only a derived writePlotFile that does not keep
+                // them makes us get them again.
+                Vector<std::string> varnames;
+                Vector<std::unique_ptr<MultiFab> > plotmf(finest_level+1);
+                Vector<const MultiFab*> plotmfp(finest_level+1);
+                for (int k(0); k <= finest_level; ++k) {
+                    Vector<std::string> names;
+                    plotmf[k] = amr_level[k]->releasePlotData(names);
+                    if ( ! plotmf[k]) {
+                        plotmf[k] = amr_level[k]->getPlotData(names);
+                    }
+                    if (k == 0) {
+                        varnames = std::move(names);
+                    }
+                    plotmfp[k] = plotmf[k].get();
+                }
+                amrex::WriteMultiLevelPlotfilePreviews(pltfileTemp, finest_level+1, plotmfp,
+                                                       varnames, Geom(), cumTime(), level_steps,
+                                                       refRatio(), plot_preview_ratio, plot_regions,
+                                                       amr_level[0]->thePlotFileType());
+            }
         } else {
             for (int k(0); k <= finest_level; ++k) {
                 amr_level[k]->writeSmallPlotFile(pltfileTemp, HeaderFile);
@@ -1643,6 +1673,10 @@ Amr::restart (const std::string& filename)
     last_checkpoint = level_steps[0];
     last_plotfile = level_steps[0];
 
+    // The next incremental checkpoint can refer to this one.
+    checkpoint_ref_file = filename;
+    n_checkpoints = 1;
+
     for (int lev = 0; lev <= finest_level; ++lev)
     {
         Box restart_domain(Geom(lev).Domain());
@@ -1679,6 +1713,8 @@ Amr::checkPoint ()
     BL_PROFILE_REGION_START("Amr::checkPoint()");
     BL_PROFILE("Amr::checkPoint()");
 
+    finishAsyncCheckPoint();
+
     VisMF::SetNOutFiles(checkpoint_nfiles);
     //
     // In checkpoint files always write out FABs in NATIVE format.
@@ -1694,6 +1730,18 @@ Amr::checkPoint ()
 
     const std::string& ckfile = amrex::Concatenate(check_file_root,level_steps[0],file_name_digits);
 
+    //
+    // Incremental checkpoints write only the data that changed since the
+    // previous checkpoint, with a full one every incremental_checkpoint.
+    //
+    const bool incremental(incremental_checkpoint > 0 && ! async_checkpoint &&
+                           ! AsyncOut::UseAsyncOut());
+    if (incremental) {
+        const bool full(n_checkpoints % incremental_checkpoint == 0 ||
+                        checkpoint_ref_file == ckfile);
+        StateData::SetIncrementalCheckPoint(true, full ? std::string() : checkpoint_ref_file);
+    }
+
     if(verbose > 0) {
 	amrex::Print() << "CHECKPOINT: file = " << ckfile << "\n";
     }
@@ -1706,7 +1754,9 @@ Amr::checkPoint ()
                              stream_max_tries);
 
   // For AsyncOut, we need to turn off stream retry and write to ckfile directly.
-  const std::string ckfileTemp = (AsyncOut::UseAsyncOut()) ? ckfile : (ckfile + ".temp");
+  // Asynchronous checkpoints are renamed by finishAsyncCheckPoint instead.
+  const std::string ckfileTemp = (AsyncOut::UseAsyncOut() && ! async_checkpoint) ? ckfile
+                                                                                 : (ckfile + ".temp");
 
   while(sretry.TryFileOutput()) {
 
@@ -1830,7 +1880,10 @@ Amr::checkPoint ()
 	amrex::Print() << "checkPoint() time = " << dCheckPointTime << " secs." << '\n';
     }
 
-    if (AsyncOut::UseAsyncOut()) {
+    if (async_checkpoint) {
+        async_checkpoint_file = ckfile;
+        break;
+    } else if (AsyncOut::UseAsyncOut()) {
         break;
     } else {
         ParallelDescriptor::Barrier("Amr::checkPoint::end");
@@ -1841,6 +1894,12 @@ Amr::checkPoint ()
     }
   }  // end while
 
+  if (incremental) {
+      StateData::SetIncrementalCheckPoint(false);
+      checkpoint_ref_file = ckfile;
+  }
+  ++n_checkpoints;
+
   //
   // Restore the previous FAB format.
   //
@@ -1851,6 +1910,27 @@ Amr::checkPoint ()
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
 
+void
+Amr::finishAsyncCheckPoint ()
+{
+    if (async_checkpoint_file.empty()) {
+        return;
+    }
+
+    BL_PROFILE("Amr::finishAsyncCheckPoint()");
+
+    AsyncOut::Finish();
+
+    ParallelDescriptor::Barrier("Amr::finishAsyncCheckPoint");
+    if (ParallelDescriptor::IOProcessor()) {
+        const std::string ckfileTemp = async_checkpoint_file + ".temp";
+        std::rename(ckfileTemp.c_str(), async_checkpoint_file.c_str());
+    }
+    ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
+
+    async_checkpoint_file.clear();
+}
+
 void
 Amr::RegridOnly (Real time, bool do_io)
 {
@@ -3201,6 +3281,22 @@ Amr::initPltAndChk ()
     write_plotfile_with_checkpoint = 1;
     pp.query("write_plotfile_with_checkpoint",write_plotfile_with_checkpoint);
 
+    plot_preview_ratio.clear();
+    pp.queryarr("plot_preview", plot_preview_ratio);
+
+    plot_regions.clear();
+    {
+        Vector<Real> lo, hi;
+        pp.queryarr("plot_region_lo", lo);
+        pp.queryarr("plot_region_hi", hi);
+        if (lo.size() != hi.size() || lo.size() % AMREX_SPACEDIM != 0) {
+            amrex::Error("amr.plot_region_lo and amr.plot_region_hi must have AMREX_SPACEDIM numbers per region");
+        }
+        for (int i = 0; i < lo.size(); i += AMREX_SPACEDIM) {
+            plot_regions.push_back(RealBox(&lo[i], &hi[i]));
+        }
+    }
+
     stream_max_tries = 4;
     pp.query("stream_max_tries",stream_max_tries);
     stream_max_tries = std::max(stream_max_tries, 1);
@@ -3220,6 +3316,13 @@ Amr::initPltAndChk ()
     if(chvInt != checkpoint_headerversion) {
       checkpoint_headerversion = static_cast<VisMF::Header::Version> (chvInt);
     }
+
+    pp.query("async_checkpoint", async_checkpoint);
+    pp.query("incremental_checkpoint", incremental_checkpoint);
+    if (async_checkpoint) {
+        AsyncOut::Start();
+        StateData::SetAsyncCheckPoint(true);
+    }
 }
 
 
@@ -140,12 +140,9 @@ AmrLevel::AmrLevel (Amr&            papa,
     finishConstructor();
 }
 
-void
-AmrLevel::writePlotFile (const std::string& dir,
-                         std::ostream&      os,
-                         VisMF::How         how)
+std::unique_ptr<MultiFab>
+AmrLevel::getPlotData (Vector<std::string>& varnames)
 {
-    int i, n;
     //
     // The list of indices of State to write to plotfile.
     // first component of pair is state_type,
@@ -176,14 +173,81 @@ AmrLevel::writePlotFile (const std::string& dir,
 	}
     }
 
-    int n_data_items = plot_var_map.size() + derive_names.size();
+    varnames.clear();
+    for (auto const& p : plot_var_map) {
+        varnames.push_back(desc_lst[p.first].name(p.second));
+    }
+    for (auto const& dname : derive_names) {
+        varnames.push_back(derive_lst.get(dname)->variableName(0));
+    }
+
+#ifdef AMREX_USE_EB
+    if (EB2::TopIndexSpaceIfPresent()) {
+        varnames.push_back("vfrac");
+    }
+#endif
+
+    int n_data_items = varnames.size();
+
+    if (n_data_items == 0)
+        amrex::Error("Must specify at least one valid data item to plot");
+
+    // get the time from the first State_Type
+    // if the State_Type is ::Interval, this will get t^{n+1/2} instead of t^n
+    Real cur_time = state[0].curTime();
+
+    //
+    // We combine all of the multifabs -- state, derived, etc -- into one
+    // multifab -- plotMF.
+    int       cnt   = 0;
+    const int nGrow = 0;
+    std::unique_ptr<MultiFab> plotMF(new MultiFab(grids,dmap,n_data_items,nGrow,MFInfo(),Factory()));
+    MultiFab* this_dat = 0;
+    //
+    // Cull data from state variables -- use no ghost cells.
+    //
+    for (int i = 0; i < static_cast<int>(plot_var_map.size()); i++)
+    {
+	int typ  = plot_var_map[i].first;
+	int comp = plot_var_map[i].second;
+	this_dat = &state[typ].newData();
+	MultiFab::Copy(*plotMF,*this_dat,comp,cnt,1,nGrow);
+	cnt++;
+    }
+
+    // derived
+    if (derive_names.size() > 0)
+    {
+	for (auto const& dname : derive_names)
+	{
+            derive(dname, cur_time, *plotMF, cnt);
+	    cnt++;
+	}
+    }
 
 #ifdef AMREX_USE_EB
     if (EB2::TopIndexSpaceIfPresent()) {
-        n_data_items += 1;
+        plotMF->setVal(0.0, cnt, 1, nGrow);
+        auto factory = static_cast<EBFArrayBoxFactory*>(m_factory.get());
+        MultiFab::Copy(*plotMF,factory->getVolFrac(),0,cnt,1,nGrow);
     }
 #endif
 
+    return plotMF;
+}
+
+void
+AmrLevel::writePlotFile (const std::string& dir,
+                         std::ostream&      os,
+                         VisMF::How         how)
+{
+    int i, n;
+
+    Vector<std::string> varnames;
+    std::unique_ptr<MultiFab> plotMF = getPlotData(varnames);
+
+    int n_data_items = varnames.size();
+
     // get the time from the first State_Type
     // if the State_Type is ::Interval, this will get t^{n+1/2} instead of t^n
     Real cur_time = state[0].curTime();
@@ -195,31 +259,14 @@ AmrLevel::writePlotFile (const std::string& dir,
         //
         os << thePlotFileType() << '\n';
 
-        if (n_data_items == 0)
-            amrex::Error("Must specify at least one valid data item to plot");
-
         os << n_data_items << '\n';
 
 	//
 	// Names of variables
 	//
-	for (i =0; i < static_cast<int>(plot_var_map.size()); i++)
-        {
-	    int typ = plot_var_map[i].first;
-	    int comp = plot_var_map[i].second;
-	    os << desc_lst[typ].name(comp) << '\n';
-        }
-
-        // derived
-        for (auto const& dname : derive_names) {
-            os << derive_lst.get(dname)->variableName(0) << '\n';
-        }
-
-#ifdef AMREX_USE_EB
-        if (EB2::TopIndexSpaceIfPresent()) {
-            os << "vfrac\n";
-        }
-#endif
+	for (auto const& name : varnames) {
+	    os << name << '\n';
+	}
 
         os << AMREX_SPACEDIM << '\n';
         os << parent->cumTime() << '\n';
@@ -313,55 +360,31 @@ AmrLevel::writePlotFile (const std::string& dir,
         }
 #endif
     }
-    //
-    // We combine all of the multifabs -- state, derived, etc -- into one
-    // multifab -- plotMF.
-    int       cnt   = 0;
-    const int nGrow = 0;
-    MultiFab  plotMF(grids,dmap,n_data_items,nGrow,MFInfo(),Factory());
-    MultiFab* this_dat = 0;
-    //
-    // Cull data from state variables -- use no ghost cells.
-    //
-    for (i = 0; i < static_cast<int>(plot_var_map.size()); i++)
-    {
-	int typ  = plot_var_map[i].first;
-	int comp = plot_var_map[i].second;
-	this_dat = &state[typ].newData();
-	MultiFab::Copy(plotMF,*this_dat,comp,cnt,1,nGrow);
-	cnt++;
-    }
-
-    // derived
-    if (derive_names.size() > 0)
-    {
-	for (auto const& dname : derive_names)
-	{
-            derive(dname, cur_time, plotMF, cnt);
-	    cnt++;
-	}
-    }
-
-#ifdef AMREX_USE_EB
-    if (EB2::TopIndexSpaceIfPresent()) {
-        plotMF.setVal(0.0, cnt, 1, nGrow);
-        auto factory = static_cast<EBFArrayBoxFactory*>(m_factory.get());
-        MultiFab::Copy(plotMF,factory->getVolFrac(),0,cnt,1,nGrow);
-    }
-#endif
-
     //
     // Use the Full pathname when naming the MultiFab.
     //
     std::string TheFullPath = FullPath;
     TheFullPath += BaseName;
     if (AsyncOut::UseAsyncOut()) {
-        VisMF::AsyncWrite(plotMF,TheFullPath);
+        VisMF::AsyncWrite(*plotMF,TheFullPath);
     } else {
-        VisMF::Write(plotMF,TheFullPath,how,true);
+        VisMF::Write(*plotMF,TheFullPath,how,true);
     }
 
     levelDirectoryCreated = false;  // ---- now that the plotfile is finished
+
+    if (parent->plotPreviews()) {
+        plot_data = std::move(plotMF);
+        plot_data_names = std::move(varnames);
+    }
+}
+
+std::unique_ptr<MultiFab>
+AmrLevel::releasePlotData (Vector<std::string>& varnames) noexcept
+{
+    varnames = std::move(plot_data_names);
+    plot_data_names.clear();
+    return std::move(plot_data);
 }
 
 
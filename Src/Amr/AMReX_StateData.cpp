@@ -25,6 +25,9 @@ static constexpr int MFNEWDATA = 0;
 static constexpr int MFOLDDATA = 1;
 
 Vector<std::string> StateData::fabArrayHeaderNames;
+bool StateData::asyncCheckPoint(false);
+bool StateData::incrementalCheckPoint(false);
+std::string StateData::checkPointRefDir;
 std::map<std::string, Vector<char> > *StateData::faHeaderMap;
 
 
@@ -823,8 +826,14 @@ StateData::checkPoint (const std::string& name,
     {
        BL_ASSERT(new_data);
        std::string mf_fullpath_new(fullpathname + NewSuffix);
-       if (AsyncOut::UseAsyncOut()) {
+       if (AsyncOut::UseAsyncOut() || asyncCheckPoint) {
            VisMF::AsyncWrite(*new_data,mf_fullpath_new);
+       } else if (incrementalCheckPoint) {
+           std::string mf_refpath_new;
+           if ( ! checkPointRefDir.empty()) {
+               mf_refpath_new = checkPointRefDir + "/" + name + NewSuffix;
+           }
+           VisMF::WriteIncremental(*new_data,mf_fullpath_new,mf_refpath_new,how);
        } else {
            VisMF::Write(*new_data,mf_fullpath_new,how);
        }
@@ -833,8 +842,14 @@ StateData::checkPoint (const std::string& name,
        {
            BL_ASSERT(old_data);
            std::string mf_fullpath_old(fullpathname + OldSuffix);
-           if (AsyncOut::UseAsyncOut()) {
+           if (AsyncOut::UseAsyncOut() || asyncCheckPoint) {
                VisMF::AsyncWrite(*old_data,mf_fullpath_old);
+           } else if (incrementalCheckPoint) {
+               std::string mf_refpath_old;
+               if ( ! checkPointRefDir.empty()) {
+                   mf_refpath_old = checkPointRefDir + "/" + name + OldSuffix;
+               }
+               VisMF::WriteIncremental(*old_data,mf_fullpath_old,mf_refpath_old,how);
            } else {
                VisMF::Write(*old_data,mf_fullpath_old,how);
            }
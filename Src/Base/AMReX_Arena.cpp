@@ -4,6 +4,7 @@
 #include <AMReX_CArena.H>
 #include <AMReX_DArena.H>
 #include <AMReX_EArena.H>
+#include <AMReX_SArena.H>
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
@@ -33,10 +34,12 @@ namespace {
     Arena* the_managed_arena = nullptr;
     Arena* the_pinned_arena = nullptr;
     Arena* the_cpu_arena = nullptr;
+    Arena* the_scratch_arena = nullptr;
 
     bool use_buddy_allocator = false;
     Long buddy_allocator_size = 0L;
     Long the_arena_init_size = 0L;
+    Long scratch_arena_chunk_size = 0L;
 #ifdef AMREX_USE_HIP
     bool the_arena_is_managed = false; // xxxxx HIP FIX HERE
 #else
@@ -160,6 +163,7 @@ Arena::Initialize ()
     BL_ASSERT(the_managed_arena == nullptr);
     BL_ASSERT(the_pinned_arena == nullptr);
     BL_ASSERT(the_cpu_arena == nullptr);
+    BL_ASSERT(the_scratch_arena == nullptr);
 
     ParmParse pp("amrex");
     pp.query("use_buddy_allocator", use_buddy_allocator);
@@ -167,6 +171,15 @@ Arena::Initialize ()
     pp.query("the_arena_init_size", the_arena_init_size);
     pp.query("the_arena_is_managed", the_arena_is_managed);
     pp.query("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
+    pp.query("scratch_arena_chunk_size", scratch_arena_chunk_size);
+    {
+        Long tc_max_bytes = CArena::thread_cache_max_bytes;
+        Long tc_max_size = CArena::thread_cache_max_size;
+        pp.query("carena_thread_cache_max_bytes", tc_max_bytes);
+        pp.query("carena_thread_cache_max_size", tc_max_size);
+        CArena::thread_cache_max_bytes = std::max(tc_max_bytes, Long(0));
+        CArena::thread_cache_max_size = std::max(tc_max_size, Long(0));
+    }
 
 #ifdef AMREX_USE_GPU
     if (use_buddy_allocator)
@@ -241,6 +254,19 @@ Arena::Initialize ()
     the_pinned_arena->free(p);
 
     the_cpu_arena = new BArena;
+
+    // Scratch memory has the same type as The_Arena's.
+#ifdef AMREX_USE_GPU
+    if (the_arena_is_managed) {
+        the_scratch_arena = new SArena(std::max(scratch_arena_chunk_size,Long(0)),
+                                       ArenaInfo().SetPreferred());
+    } else {
+        the_scratch_arena = new SArena(std::max(scratch_arena_chunk_size,Long(0)),
+                                       ArenaInfo().SetDeviceMemory());
+    }
+#else
+    the_scratch_arena = new SArena(std::max(scratch_arena_chunk_size,Long(0)));
+#endif
 }
 
 void
@@ -297,6 +323,12 @@ Arena::PrintUsage ()
             p->PrintUsage("The  Pinned Arena");
         }
     }
+    if (The_Scratch_Arena()) {
+        SArena* p = dynamic_cast<SArena*>(The_Scratch_Arena());
+        if (p) {
+            p->PrintUsage("The Scratch Arena");
+        }
+    }
 }
     
 void
@@ -326,6 +358,9 @@ Arena::Finalize ()
 
     delete the_cpu_arena;
     the_cpu_arena = nullptr;
+
+    delete the_scratch_arena;
+    the_scratch_arena = nullptr;
 }
     
 Arena*
@@ -363,4 +398,10 @@ The_Cpu_Arena ()
     return the_cpu_arena;
 }
 
+Arena*
+The_Scratch_Arena ()
+{
+    return the_scratch_arena;
+}
+
 }
@@ -38,8 +38,18 @@ void Initialize ()
     int nprocs = ParallelDescriptor::NProcs();
     s_noutfiles = std::min(s_noutfiles, nprocs);
 
+    if (s_asyncout) Start();
+
+    ExecOnFinalize(Finalize);
+}
+
+void Start ()
+{
+    if (s_thread) return;
+
 #ifdef AMREX_USE_MPI
-    if (s_asyncout and s_noutfiles < nprocs)
+    int nprocs = ParallelDescriptor::NProcs();
+    if (s_noutfiles < nprocs)
     {
         int provided = -1;
         MPI_Query_thread(&provided);
@@ -55,9 +65,7 @@ void Initialize ()
     }
 #endif
 
-    if (s_asyncout) s_thread.reset(new BackgroundThread());
-
-    ExecOnFinalize(Finalize);
+    s_thread.reset(new BackgroundThread());
 }
 
 void Finalize ()
@@ -74,6 +82,8 @@ void Finalize ()
 
 bool UseAsyncOut () { return s_asyncout; }
 
+bool Running () { return s_thread != nullptr; }
+
 WriteInfo GetWriteInfo (int rank)
 {
     const int nfiles = s_noutfiles;
@@ -99,17 +109,19 @@ WriteInfo GetWriteInfo (int rank)
 
 void Submit (std::function<void()>&& a_f)
 {
+    AMREX_ASSERT(s_thread);
     s_thread->Submit(std::move(a_f));
 }
 
 void Submit (std::function<void()> const& a_f)
 {
+    AMREX_ASSERT(s_thread);
     s_thread->Submit(a_f);
 }
 
 void Finish ()
 {
-    s_thread->Finish();
+    if (s_thread) s_thread->Finish();
 }
 
 void Wait ()
@@ -1,14 +1,63 @@
 
 #include <utility>
 #include <cstring>
+#include <memory>
+#include <algorithm>
 
 #include <AMReX_CArena.H>
 #include <AMReX_BLassert.H>
 #include <AMReX_Gpu.H>
 #include <AMReX_ParallelReduce.H>
+#include <AMReX_OpenMP.H>
 
 namespace amrex {
 
+std::size_t CArena::thread_cache_max_bytes = 0;
+std::size_t CArena::thread_cache_max_size  =  4*1024*1024;
+
+namespace {
+    constexpr std::size_t MinClassSize = 256;
+    constexpr int MaxCacheBatch = 8;
+
+    std::atomic<std::uint64_t> carena_next_id{0};
+
+    //
+    // The arenas that are alive, so that a thread exiting can tell whether
+    // the arena its cache belongs to has been deleted already.  These are
+    // never destroyed because threads may exit during static destruction.
+    //
+    std::mutex& live_arenas_mutex ()
+    {
+        static std::mutex* m = new std::mutex;
+        return *m;
+    }
+
+    std::unordered_map<std::uint64_t,CArena*>& live_arenas ()
+    {
+        static auto* m = new std::unordered_map<std::uint64_t,CArena*>;
+        return *m;
+    }
+}
+
+struct CArena::ThreadCache
+{
+    ThreadCache (std::uint64_t a_id, int nclasses) : id(a_id), mag(nclasses) {}
+
+    ~ThreadCache ()
+    {
+        std::lock_guard<std::mutex> lock(live_arenas_mutex());
+        auto it = live_arenas().find(id);
+        if (it != live_arenas().end()) {
+            it->second->releaseThreadCache(*this, true);
+        }
+    }
+
+    std::uint64_t id;
+    std::vector<std::vector<void*> > mag;
+    //! The number of bytes in mag.
+    std::size_t bytes = 0;
+};
+
 CArena::CArena (std::size_t hunk_size, ArenaInfo info)
 {
     arena_info = info;
@@ -21,20 +70,151 @@ CArena::CArena (std::size_t hunk_size, ArenaInfo info)
 
     BL_ASSERT(m_hunk >= hunk_size);
     BL_ASSERT(m_hunk%Arena::align_size == 0);
+
+    m_tc_max_bytes = thread_cache_max_bytes;
+    m_tc_max_size = std::min(std::min(thread_cache_max_size, m_tc_max_bytes),
+                             std::size_t(1) << 30);
+    m_tc_nclasses = (m_tc_max_size > 0) ? sizeClass(m_tc_max_size) + 1 : 0;
+    if (m_tc_max_size == 0) m_tc_max_bytes = 0;
+
+    m_id = carena_next_id++;
+    std::lock_guard<std::mutex> lock(live_arenas_mutex());
+    live_arenas()[m_id] = this;
 }
 
 CArena::~CArena ()
 {
+    {
+        std::lock_guard<std::mutex> lock(live_arenas_mutex());
+        live_arenas().erase(m_id);
+    }
     for (unsigned int i = 0, N = m_alloc.size(); i < N; i++) {
         deallocate_system(m_alloc[i].first, m_alloc[i].second);
     }
 }
 
+int
+CArena::sizeClass (std::size_t nbytes) noexcept
+{
+    //
+    // Four classes per power of two, so at most 25% is wasted by rounding.
+    //
+    if (nbytes <= MinClassSize) return 0;
+    const std::size_t m = nbytes - 1;
+    int k = 8;
+    while ((m >> (k+1)) != 0) ++k;
+    const int sub = static_cast<int>((m >> (k-2)) & 3);
+    return (k-8)*4 + sub + 1;
+}
+
+std::size_t
+CArena::classSize (int c) noexcept
+{
+    if (c == 0) return MinClassSize;
+    const int k = (c-1)/4 + 8;
+    const std::size_t sub = (c-1)%4;
+    return (5+sub) << (k-2);
+}
+
+CArena::Shard&
+CArena::shard (void* vp) noexcept
+{
+    auto i = reinterpret_cast<std::uintptr_t>(vp);
+    i = (i >> 8) ^ (i >> 16);
+    return m_shards[i % NumShards];
+}
+
+CArena::ThreadCache&
+CArena::threadCache ()
+{
+    static thread_local std::unordered_map<std::uint64_t,std::unique_ptr<ThreadCache> > caches;
+    static thread_local ThreadCache* last = nullptr;
+    if (last == nullptr || last->id != m_id) {
+        auto& p = caches[m_id];
+        if (p == nullptr) {
+            p.reset(new ThreadCache(m_id, m_tc_nclasses));
+        }
+        last = p.get();
+    }
+    return *last;
+}
+
+void
+CArena::releaseThreadCache (ThreadCache& tc, bool all)
+{
+    //
+    // Give back all the blocks, or the older half of the blocks of each
+    // size class, to the free list.
+    //
+    std::size_t n = 0;
+    for (auto const& mag : tc.mag) {
+        const std::size_t nrel = all ? mag.size() : (mag.size()+1)/2;
+        for (std::size_t i = 0; i < nrel; ++i) {
+            Shard& s = shard(mag[i]);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.blocks.erase(mag[i]);
+        }
+        n += nrel;
+    }
+    m_tc_nblocks -= n;
+
+    std::lock_guard<std::mutex> lock(carena_mutex);
+    for (int c = 0, N = tc.mag.size(); c < N; ++c) {
+        auto& mag = tc.mag[c];
+        const std::size_t nrel = all ? mag.size() : (mag.size()+1)/2;
+        for (std::size_t i = 0; i < nrel; ++i) {
+            free_protected(mag[i]);
+        }
+        mag.erase(mag.begin(), mag.begin()+nrel);
+        tc.bytes -= nrel*classSize(c);
+    }
+}
+
 void*
 CArena::alloc (std::size_t nbytes)
 {
-    std::lock_guard<std::mutex> lock(carena_mutex);
+    if (m_tc_max_bytes > 0 && nbytes <= m_tc_max_size && OpenMP::in_parallel())
+    {
+        const int c = sizeClass(nbytes);
+        const std::size_t csize = classSize(c);
+        ThreadCache& tc = threadCache();
+        auto& mag = tc.mag[c];
+        if (mag.empty())
+        {
+            //
+            // Refill in a batch so the arena's mutex is taken less often.
+            //
+            int nbatch = static_cast<int>(m_tc_max_bytes / (64*csize));
+            nbatch = std::max(1, std::min(nbatch, MaxCacheBatch));
+            {
+                std::lock_guard<std::mutex> lock(carena_mutex);
+                for (int i = 0; i < nbatch; ++i) {
+                    mag.push_back(alloc_protected(csize));
+                }
+            }
+            for (void* vp : mag) {
+                Shard& s = shard(vp);
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.blocks[vp] = c;
+            }
+            m_tc_nblocks += nbatch;
+            tc.bytes += nbatch*csize;
+        }
+        void* vp = mag.back();
+        mag.pop_back();
+        tc.bytes -= csize;
+        return vp;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(carena_mutex);
+        return alloc_protected(nbytes);
+    }
+}
 
+void*
+CArena::alloc_protected (std::size_t nbytes)
+{
     nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
     //
     // Find node in freelist at lowest memory address that'll satisfy request.
@@ -110,13 +290,53 @@ CArena::alloc (std::size_t nbytes)
 void
 CArena::free (void* vp)
 {
-    std::lock_guard<std::mutex> lock(carena_mutex);
-
     if (vp == 0)
         //
         // Allow calls with NULL as allowed by C++ delete.
         //
         return;
+
+    if (m_tc_nblocks.load(std::memory_order_relaxed) > 0)
+    {
+        int c = -1;
+        Shard& s = shard(vp);
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.blocks.find(vp);
+            if (it != s.blocks.end()) {
+                c = it->second;
+                if (!OpenMP::in_parallel()) {
+                    s.blocks.erase(it);
+                }
+            }
+        }
+        if (c >= 0)
+        {
+            if (OpenMP::in_parallel())
+            {
+                const std::size_t csize = classSize(c);
+                ThreadCache& tc = threadCache();
+                if (tc.bytes + csize > m_tc_max_bytes) {
+                    releaseThreadCache(tc, false);
+                }
+                tc.mag[c].push_back(vp);
+                tc.bytes += csize;
+                return;
+            }
+            else
+            {
+                --m_tc_nblocks;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(carena_mutex);
+    free_protected(vp);
+}
+
+void
+CArena::free_protected (void* vp)
+{
     //
     // `vp' had better be in the busy list.
     //
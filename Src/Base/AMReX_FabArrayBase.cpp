@@ -1,5 +1,7 @@
 
 #include <algorithm>
+#include <limits>
+#include <cstdint>
 #include <AMReX_FabArrayBase.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
@@ -9,6 +11,11 @@
 #include <AMReX_BArena.H>
 #include <AMReX_CArena.H>
 
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
 #ifdef AMREX_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
 #endif
@@ -24,6 +31,8 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::use_neighbor_collectives;
+bool    FabArrayBase::numa_first_touch;
 
 #if defined(AMREX_USE_GPU)
 
@@ -67,17 +76,190 @@ FabArrayBase::CacheStats           FabArrayBase::m_CPC_stats("CopyCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FPinfo_stats("FillPatchCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CFinfo_stats("CrseFineCache");
 
+FabArrayBase::CacheIndex<FabArrayBase::FB>  FabArrayBase::m_FBC_index;
+FabArrayBase::CacheIndex<FabArrayBase::CPC> FabArrayBase::m_CPC_index;
+
+int                                FabArrayBase::m_num_eviction_locks = 0;
+Long                               FabArrayBase::m_cache_clock = 0;
+
 std::map<FabArrayBase::BDKey, int> FabArrayBase::m_BD_count;
 
 FabArrayBase::FabArrayStats        FabArrayBase::m_FA_stats;
 
 std::map<std::string,FabArrayBase::meminfo> FabArrayBase::m_mem_usage;
+Long FabArrayBase::m_numa_local_pages = 0;
+Long FabArrayBase::m_numa_sampled_pages = 0;
 std::vector<std::string>                    FabArrayBase::m_region_tag;
 
 namespace
 {
     Arena* the_fa_arena = nullptr;
     bool initialized = false;
+
+    // Freeing a neighbor communicator is collective.  Without a
+    // collective eviction, items that own one must be kept.
+    bool isPinned (FabArrayBase::CommMetaData const& x) noexcept {
+#ifdef BL_USE_MPI
+        return x.hasNeighborComm();
+#else
+        amrex::ignore_unused(x);
+        return false;
+#endif
+    }
+    bool isPinned (FabArrayBase::FPinfo const&) noexcept { return false; }
+    bool isPinned (FabArrayBase::CFinfo const&) noexcept { return false; }
+
+    void unindex (FabArrayBase::FB const* p) noexcept { FabArrayBase::m_FBC_index.erase(p->m_hash, p); }
+    void unindex (FabArrayBase::CPC const* p) noexcept { FabArrayBase::m_CPC_index.erase(p->m_hash, p); }
+    void unindex (FabArrayBase::FPinfo const*) noexcept {}
+    void unindex (FabArrayBase::CFinfo const*) noexcept {}
+
+    void hashCombine (std::size_t& seed, std::size_t v) noexcept {
+        seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    void hashCombine (std::size_t& seed, IntVect const& iv) noexcept {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            hashCombine(seed, static_cast<std::size_t>(iv[idim]));
+        }
+    }
+
+    // The low bits are used to index the hash table, but BDKey hashes
+    // are built from pointers, so mix all bits into them.
+    std::size_t hashFinalize (std::size_t h) noexcept {
+        std::uint64_t x = h;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<std::size_t>(x);
+    }
+
+    std::size_t fbHash (FabArrayBase::BDKey const& bdkey, IndexType typ, IntVect const& crse_ratio,
+                        IntVect const& nghost, bool cross, bool multi_ghost, bool epo,
+                        Periodicity const& period) noexcept
+    {
+        std::size_t h = bdkey.hash();
+        hashCombine(h, typ.toIntVect());
+        hashCombine(h, crse_ratio);
+        hashCombine(h, nghost);
+        hashCombine(h, (cross ? 1 : 0) | (multi_ghost ? 2 : 0) | (epo ? 4 : 0));
+        hashCombine(h, period.Domain().length());
+        return hashFinalize(h);
+    }
+
+    std::size_t cpcHash (FabArrayBase::BDKey const& dstkey, FabArrayBase::BDKey const& srckey,
+                         IntVect const& dstng, IntVect const& srcng,
+                         Periodicity const& period) noexcept
+    {
+        std::size_t h = dstkey.hash();
+        hashCombine(h, srckey.hash());
+        hashCombine(h, dstng);
+        hashCombine(h, srcng);
+        hashCombine(h, period.Domain().length());
+        return hashFinalize(h);
+    }
+
+    //
+    // Evict the least recently used items from cache until its bytes are
+    // within stats.max_bytes.  The item just built is never evicted.  If
+    // collective is true, all processes in the current ParallelContext
+    // make the same decision based on the max bytes of each item.  The
+    // eviction locks are reduced too, because they are taken locally
+    // (e.g., only by processes with work in a ParallelCopy).  If the
+    // processes do not hold the same number of items (e.g., some were
+    // built in a subcommunicator), nothing is evicted.
+    //
+    template <class Cache, class T>
+    void evictLRU (Cache& cache, FabArrayBase::CacheStats& stats, T const* keep, bool collective)
+    {
+        if (stats.max_bytes < 0) return;
+        if (!collective && FabArrayBase::m_num_eviction_locks > 0) return;
+
+        Vector<T*> items;
+        for (auto const& kv : cache) {
+            if (std::find(items.begin(), items.end(), kv.second) == items.end()) {
+                items.push_back(kv.second);
+            }
+        }
+        std::sort(items.begin(), items.end(),
+                  [] (T const* a, T const* b) { return a->m_last_use < b->m_last_use; });
+
+        const int n = items.size();
+        if (collective) {
+            Long hdr[3] = {FabArrayBase::m_num_eviction_locks, Long(n), -Long(n)};
+            ParallelAllReduce::Max(hdr, 3, ParallelContext::CommunicatorSub());
+            if (hdr[0] > 0 || hdr[1] != -hdr[2]) return;
+        }
+        Vector<Long> bytes(n);
+        for (int i = 0; i < n; ++i) {
+            bytes[i] = items[i]->bytes();
+        }
+        if (collective) {
+            ParallelAllReduce::Max(bytes.data(), n, ParallelContext::CommunicatorSub());
+        }
+
+        Long total = 0;
+        for (int i = 0; i < n; ++i) total += bytes[i];
+        if (!stats.overBudget(total)) return;
+
+        Vector<T*> victims;
+        bool skipped_pinned = false;
+        for (int i = 0; i < n && stats.overBudget(total); ++i) {
+            if (items[i] == keep) continue;
+            if (!collective && isPinned(*items[i])) {
+                skipped_pinned = true;
+            } else {
+                victims.push_back(items[i]);
+                total -= bytes[i];
+            }
+        }
+
+        if (skipped_pinned && stats.overBudget(total) && !stats.warned) {
+            stats.warned = true;
+            amrex::Warning(stats.name + " is over its byte budget, but items owning a "
+                           "neighbor communicator can only be evicted collectively");
+        }
+
+        for (auto it = cache.begin(); it != cache.end(); ) {
+            if (std::find(victims.begin(), victims.end(), it->second) != victims.end()) {
+                it = cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto p : victims) {
+            unindex(p);
+            stats.bytes -= p->bytes();
+            stats.recordEvict(p->m_nuse);
+            delete p;
+        }
+    }
+}
+
+void
+FabArrayBase::CacheEvictionGuard::lock () noexcept
+{
+    if (!m_locked) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++m_num_eviction_locks;
+        m_locked = true;
+    }
+}
+
+void
+FabArrayBase::CacheEvictionGuard::unlock () noexcept
+{
+    if (m_locked) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        --m_num_eviction_locks;
+        m_locked = false;
+    }
 }
 
 void
@@ -90,6 +272,8 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::use_neighbor_collectives = false;
+    FabArrayBase::numa_first_touch = false;
 
     ParmParse pp("fabarray");
 
@@ -116,6 +300,19 @@ FabArrayBase::Initialize ()
         MaxComp = 1;
     }
 
+    pp.query("use_neighbor_collectives", FabArrayBase::use_neighbor_collectives);
+    pp.query("numa_first_touch", FabArrayBase::numa_first_touch);
+
+    // Byte budgets of the caches.  Negative means unlimited.
+    pp.query("tile_cache_max_bytes",      m_TAC_stats.max_bytes);
+    pp.query("fb_cache_max_bytes",        m_FBC_stats.max_bytes);
+    pp.query("cpc_cache_max_bytes",       m_CPC_stats.max_bytes);
+    pp.query("fillpatch_cache_max_bytes", m_FPinfo_stats.max_bytes);
+    pp.query("crsefine_cache_max_bytes",  m_CFinfo_stats.max_bytes);
+#if !defined(BL_USE_MPI) || (MPI_VERSION < 3)
+    FabArrayBase::use_neighbor_collectives = false;
+#endif
+
 #ifdef AMREX_USE_GPU
     if (ParallelDescriptor::UseGpuAwareMpi()) {
         the_fa_arena = The_Arena();
@@ -259,7 +456,7 @@ FabArrayBase::CPC::bytes () const
 Long
 FabArrayBase::FB::bytes () const
 {
-    int cnt = sizeof(FabArrayBase::FB);
+    Long cnt = sizeof(FabArrayBase::FB);
 
     if (m_LocTags)
 	cnt += amrex::bytesOf(*m_LocTags);
@@ -539,10 +736,9 @@ FabArrayBase::flushCPC (bool no_assertion) const
 	    }
 	}
 
-#ifdef AMREX_MEM_PROFILING
 	m_CPC_stats.bytes -= it->second->bytes();
-#endif
 	m_CPC_stats.recordErase(it->second->m_nuse);
+	m_CPC_index.erase(it->second->m_hash, it->second);
 	delete it->second;
     }
 
@@ -566,9 +762,8 @@ FabArrayBase::flushCPCache ()
 	}
     }
     m_TheCPCache.clear();
-#ifdef AMREX_MEM_PROFILING
+    m_CPC_index.clear();
     m_CPC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::CPC&
@@ -583,39 +778,45 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
     const BDKey& srckey = src.getBDKey();
     const BDKey& dstkey =     getBDKey();
 
-    std::pair<CPCacheIter,CPCacheIter> er_it = m_TheCPCache.equal_range(dstkey);
+    const std::size_t h = cpcHash(dstkey, srckey, dstng, srcng, period);
 
-    for (CPCacheIter it = er_it.first; it != er_it.second; ++it)
+    CPC* cpc = m_CPC_index.find(h, [&] (CPC const& x) {
+        return x.m_srcng  == srcng &&
+               x.m_dstng  == dstng &&
+               x.m_srcbdk == srckey &&
+               x.m_dstbdk == dstkey &&
+               x.m_period == period &&
+               x.m_srcba  == src.boxArray() &&
+               x.m_dstba  == boxArray();
+    });
+
+    if (cpc)
     {
-	if (it->second->m_srcng  == srcng &&
-	    it->second->m_dstng  == dstng &&
-	    it->second->m_srcbdk == srckey &&
-	    it->second->m_dstbdk == dstkey &&
-	    it->second->m_period == period &&
-	    it->second->m_srcba  == src.boxArray() &&
-	    it->second->m_dstba  == boxArray())
-	{
-	    ++(it->second->m_nuse);
-	    m_CPC_stats.recordUse();
-	    return *(it->second);
-	}
+        ++(cpc->m_nuse);
+        cpc->m_last_use = ++m_cache_clock;
+        m_CPC_stats.recordUse();
+        return *cpc;
     }
     
     // Have to build a new one
     CPC* new_cpc = new CPC(*this, dstng, src, srcng, period);
+    new_cpc->m_hash = h;
 
-#ifdef AMREX_MEM_PROFILING
-    m_CPC_stats.bytes += new_cpc->bytes();
-    m_CPC_stats.bytes_hwm = std::max(m_CPC_stats.bytes_hwm, m_CPC_stats.bytes);
-#endif    
+    m_CPC_stats.addBytes(new_cpc->bytes());
 
     new_cpc->m_nuse = 1;
+    new_cpc->m_last_use = ++m_cache_clock;
     m_CPC_stats.recordBuild();
     m_CPC_stats.recordUse();
 
-    m_TheCPCache.insert(er_it.second, CPCache::value_type(dstkey,new_cpc));
+    m_TheCPCache.insert(CPCache::value_type(dstkey,new_cpc));
     if (srckey != dstkey)
-	m_TheCPCache.insert(          CPCache::value_type(srckey,new_cpc));
+	m_TheCPCache.insert(CPCache::value_type(srckey,new_cpc));
+    m_CPC_index.insert(h, new_cpc);
+
+    // With neighbor collectives, the items may own a neighbor
+    // communicator, so the eviction has to be collective.
+    evictLRU(m_TheCPCache, m_CPC_stats, new_cpc, use_neighbor_collectives);
 
     return *new_cpc;
 }
@@ -1054,10 +1255,9 @@ FabArrayBase::flushFB (bool no_assertion) const
     std::pair<FBCacheIter,FBCacheIter> er_it = m_TheFBCache.equal_range(m_bdkey);
     for (FBCacheIter it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef AMREX_MEM_PROFILING
 	m_FBC_stats.bytes -= it->second->bytes();
-#endif
 	m_FBC_stats.recordErase(it->second->m_nuse);
+	m_FBC_index.erase(it->second->m_hash, it->second);
 	delete it->second;
     }
     m_TheFBCache.erase(er_it.first, er_it.second);
@@ -1072,9 +1272,8 @@ FabArrayBase::flushFBCache ()
 	delete it->second;
     }
     m_TheFBCache.clear();
-#ifdef AMREX_MEM_PROFILING
+    m_FBC_index.clear();
     m_FBC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::FB&
@@ -1084,36 +1283,47 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
     BL_PROFILE("FabArrayBase::getFB()");
 
     BL_ASSERT(getBDKey() == m_bdkey);
-    std::pair<FBCacheIter,FBCacheIter> er_it = m_TheFBCache.equal_range(m_bdkey);
-    for (FBCacheIter it = er_it.first; it != er_it.second; ++it)
+
+    const std::size_t h = fbHash(m_bdkey, boxArray().ixType(), boxArray().crseRatio(),
+                                 nghost, cross, m_multi_ghost, enforce_periodicity_only, period);
+
+    FB* fb = m_FBC_index.find(h, [&] (FB const& x) {
+        return x.m_bdk        == m_bdkey                  &&
+               x.m_typ        == boxArray().ixType()      &&
+               x.m_crse_ratio == boxArray().crseRatio()   &&
+               x.m_ngrow      == nghost                   &&
+               x.m_cross      == cross                    &&
+               x.m_multi_ghost== m_multi_ghost            &&
+               x.m_epo        == enforce_periodicity_only &&
+               x.m_period     == period;
+    });
+
+    if (fb)
     {
-	if (it->second->m_typ        == boxArray().ixType()      &&
-            it->second->m_crse_ratio == boxArray().crseRatio()   &&
-	    it->second->m_ngrow      == nghost                   &&
-	    it->second->m_cross      == cross                    &&
-	    it->second->m_multi_ghost== m_multi_ghost            &&
-	    it->second->m_epo        == enforce_periodicity_only &&
-	    it->second->m_period     == period              )
-	{
-	    ++(it->second->m_nuse);
-	    m_FBC_stats.recordUse();
-	    return *(it->second);
-	}
+        ++(fb->m_nuse);
+        fb->m_last_use = ++m_cache_clock;
+        m_FBC_stats.recordUse();
+        return *fb;
     }
 
     // Have to build a new one
     FB* new_fb = new FB(*this, nghost, cross, period, enforce_periodicity_only,m_multi_ghost);
+    new_fb->m_bdk = m_bdkey;
+    new_fb->m_hash = h;
 
-#ifdef BL_PROFILE
-    m_FBC_stats.bytes += new_fb->bytes();
-    m_FBC_stats.bytes_hwm = std::max(m_FBC_stats.bytes_hwm, m_FBC_stats.bytes);
-#endif
+    m_FBC_stats.addBytes(new_fb->bytes());
 
     new_fb->m_nuse = 1;
+    new_fb->m_last_use = ++m_cache_clock;
     m_FBC_stats.recordBuild();
     m_FBC_stats.recordUse();
 
-    m_TheFBCache.insert(er_it.second, FBCache::value_type(m_bdkey,new_fb));
+    m_TheFBCache.insert(FBCache::value_type(m_bdkey,new_fb));
+    m_FBC_index.insert(h, new_fb);
+
+    // With neighbor collectives, the items may own a neighbor
+    // communicator, so the eviction has to be collective.
+    evictLRU(m_TheFBCache, m_FBC_stats, new_fb, use_neighbor_collectives);
 
     return *new_fb;
 }
@@ -1333,6 +1543,7 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
 	    it->second->m_coarsener->doit(it->second->m_dstdomain) == coarsener.doit(dstdomain))
 	{
 	    ++(it->second->m_nuse);
+	    it->second->m_last_use = ++m_cache_clock;
 	    m_FPinfo_stats.recordUse();
 	    return *(it->second);
 	}
@@ -1342,12 +1553,10 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
     FPinfo* new_fpc = new FPinfo(srcfa, dstfa, dstdomain, dstng, coarsener,
                                  fgeom.Domain(), cgeom.Domain(), index_space);
 
-#ifdef AMREX_MEM_PROFILING
-    m_FPinfo_stats.bytes += new_fpc->bytes();
-    m_FPinfo_stats.bytes_hwm = std::max(m_FPinfo_stats.bytes_hwm, m_FPinfo_stats.bytes);
-#endif
+    m_FPinfo_stats.addBytes(new_fpc->bytes());
     
     new_fpc->m_nuse = 1;
+    new_fpc->m_last_use = ++m_cache_clock;
     m_FPinfo_stats.recordBuild();
     m_FPinfo_stats.recordUse();
 
@@ -1355,6 +1564,9 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
     if (srckey != dstkey)
 	m_TheFillPatchCache.insert(          FPinfoCache::value_type(srckey,new_fpc));
 
+    // Building FPinfo is collective.  So is evicting it.
+    evictLRU(m_TheFillPatchCache, m_FPinfo_stats, new_fpc, true);
+
     return *new_fpc;
 }
 
@@ -1387,9 +1599,7 @@ FabArrayBase::flushFPinfo (bool no_assertion)
 	    }
 	} 
 
-#ifdef AMREX_MEM_PROFILING
 	m_FPinfo_stats.bytes -= it->second->bytes();
-#endif
 	m_FPinfo_stats.recordErase(it->second->m_nuse);
 	delete it->second;
     }
@@ -1496,6 +1706,7 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
             it->second->m_ng          == ng)
         {
             ++(it->second->m_nuse);
+            it->second->m_last_use = ++m_cache_clock;
             m_CFinfo_stats.recordUse();
             return *(it->second);
         }
@@ -1504,17 +1715,18 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
     // Have to build a new one
     CFinfo* new_cfinfo = new CFinfo(finefa, finegm, ng, include_periodic, include_physbndry);
 
-#ifdef AMREX_MEM_PROFILING
-    m_CFinfo_stats.bytes += new_cfinfo->bytes();
-    m_CFinfo_stats.bytes_hwm = std::max(m_CFinfo_stats.bytes_hwm, m_CFinfo_stats.bytes);
-#endif
+    m_CFinfo_stats.addBytes(new_cfinfo->bytes());
 
     new_cfinfo->m_nuse = 1;
+    new_cfinfo->m_last_use = ++m_cache_clock;
     m_CFinfo_stats.recordBuild();
     m_CFinfo_stats.recordUse();
 
     m_TheCrseFineCache.insert(er_it.second, CFinfoCache::value_type(key,new_cfinfo));
 
+    // Building CFinfo is collective.  So is evicting it.
+    evictLRU(m_TheCrseFineCache, m_CFinfo_stats, new_cfinfo, true);
+
     return *new_cfinfo;
 }
 
@@ -1526,9 +1738,7 @@ FabArrayBase::flushCFinfo (bool no_assertion)
     auto er_it = m_TheCrseFineCache.equal_range(m_bdkey);
     for (auto it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef AMREX_MEM_PROFILING
         m_CFinfo_stats.bytes -= it->second->bytes();
-#endif
         m_CFinfo_stats.recordErase(it->second->m_nuse);
         delete it->second;
     }
@@ -1544,11 +1754,7 @@ FabArrayBase::Finalize ()
 
     if (ParallelDescriptor::IOProcessor() && amrex::system::verbose > 1) {
 	m_FA_stats.print();
-	m_TAC_stats.print();
-	m_FBC_stats.print();
-	m_CPC_stats.print();
-	m_FPinfo_stats.print();
-	m_CFinfo_stats.print();
+	printCacheStats();
     }
 
     if (amrex::system::verbose > 1) {
@@ -1572,7 +1778,7 @@ FabArrayBase::Finalize ()
 }
 
 const FabArrayBase::TileArray* 
-FabArrayBase::getTileArray (const IntVect& tilesize) const
+FabArrayBase::getTileArray (const IntVect& tilesize, CacheEvictionGuard* guard) const
 {
     TileArray* p;
 
@@ -1587,18 +1793,18 @@ FabArrayBase::getTileArray (const IntVect& tilesize) const
 	if (p->nuse == -1) {
 	    buildTileArray(tilesize, *p);
 	    p->nuse = 0;
+	    p->last_use = ++m_cache_clock;
 	    m_TAC_stats.recordBuild();
-#ifdef AMREX_MEM_PROFILING
-	    m_TAC_stats.bytes += p->bytes();
-	    m_TAC_stats.bytes_hwm = std::max(m_TAC_stats.bytes_hwm,
-					     m_TAC_stats.bytes);
-#endif
+	    m_TAC_stats.addBytes(p->bytes());
+	    evictTileArrays(p);
 	}
+	if (guard) guard->lock();
 #ifdef _OPENMP
 #pragma omp master
 #endif
 	{
 	    ++(p->nuse);
+	    p->last_use = ++m_cache_clock;
 	    m_TAC_stats.recordUse();
         }
     }
@@ -1606,6 +1812,40 @@ FabArrayBase::getTileArray (const IntVect& tilesize) const
     return p;
 }
 
+void
+FabArrayBase::evictTileArrays (TileArray const* keep)
+{
+    // Called inside critical(gettilearray).
+    int nlocks;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+    nlocks = m_num_eviction_locks;
+    if (nlocks > 0 || !m_TAC_stats.overBudget(m_TAC_stats.bytes)) return;
+
+    using Item = std::pair<TACache::iterator, TAMap::iterator>;
+    Vector<Item> items;
+    for (auto tao_it = m_TheTileArrayCache.begin(); tao_it != m_TheTileArrayCache.end(); ++tao_it) {
+        for (auto tai_it = tao_it->second.begin(); tai_it != tao_it->second.end(); ++tai_it) {
+            if (&(tai_it->second) != keep && tai_it->second.nuse >= 0) {
+                items.emplace_back(tao_it, tai_it);
+            }
+        }
+    }
+    std::sort(items.begin(), items.end(), [] (Item const& a, Item const& b)
+              { return a.second->second.last_use < b.second->second.last_use; });
+
+    for (auto& item : items) {
+        if (!m_TAC_stats.overBudget(m_TAC_stats.bytes)) break;
+        m_TAC_stats.bytes -= item.second->second.bytes();
+        m_TAC_stats.recordEvict(item.second->second.nuse);
+        item.first->second.erase(item.second);
+        if (item.first->second.empty()) {
+            m_TheTileArrayCache.erase(item.first);
+        }
+    }
+}
+
 void
 FabArrayBase::buildTileArray (const IntVect& tileSize, TileArray& ta) const
 {
@@ -1714,9 +1954,7 @@ FabArrayBase::flushTileArray (const IntVect& tileSize, bool no_assertion) const
 	    for (TAMap::const_iterator tai_it = tao_it->second.begin();
 		 tai_it != tao_it->second.end(); ++tai_it)
 	    {
-#ifdef AMREX_MEM_PROFILING
 		m_TAC_stats.bytes -= tai_it->second.bytes();
-#endif		
 		m_TAC_stats.recordErase(tai_it->second.nuse);
 	    }
 	    tao.erase(tao_it);
@@ -1727,9 +1965,7 @@ FabArrayBase::flushTileArray (const IntVect& tileSize, bool no_assertion) const
             const IntVect& crse_ratio = boxArray().crseRatio();
 	    TAMap::iterator tai_it = tai.find(std::pair<IntVect,IntVect>(tileSize,crse_ratio));
 	    if (tai_it != tai.end()) {
-#ifdef AMREX_MEM_PROFILING
 		m_TAC_stats.bytes -= tai_it->second.bytes();
-#endif		
 		m_TAC_stats.recordErase(tai_it->second.nuse);
 		tai.erase(tai_it);
 	    }
@@ -1750,9 +1986,7 @@ FabArrayBase::flushTileArrayCache ()
 	}
     }
     m_TheTileArrayCache.clear();
-#ifdef AMREX_MEM_PROFILING
     m_TAC_stats.bytes = 0L;
-#endif
 }
 
 void
@@ -1872,6 +2106,130 @@ FabArrayBase::CheckRcvStats(Vector<MPI_Status>& recv_stats,
     return true;
 }
 
+FabArrayBase::CommMetaData::~CommMetaData ()
+{
+    if (m_nbr_comm != MPI_COMM_NULL) {
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized) {
+            MPI_Comm_free(&m_nbr_comm);
+        }
+    }
+}
+
+MPI_Comm
+FabArrayBase::CommMetaData::getNeighborComm () const
+{
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+
+    if (m_nbr_comm != MPI_COMM_NULL && m_nbr_parent == comm) {
+        return m_nbr_comm;
+    }
+
+    if (m_nbr_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&m_nbr_comm);
+    }
+
+#if (MPI_VERSION >= 3)
+    BL_PROFILE("CommMetaData::getNeighborComm()");
+
+    // The order of the neighbors must be the same as the order of the
+    // send and recv buffers, i.e., the order of the maps.
+    Vector<int> srcs, dsts;
+    srcs.reserve(m_RcvTags->size());
+    dsts.reserve(m_SndTags->size());
+    for (auto const& kv : *m_RcvTags) {
+        srcs.push_back(ParallelContext::global_to_local_rank(kv.first));
+    }
+    for (auto const& kv : *m_SndTags) {
+        dsts.push_back(ParallelContext::global_to_local_rank(kv.first));
+    }
+
+    BL_MPI_REQUIRE( MPI_Dist_graph_create_adjacent(comm,
+                                                   srcs.size(), srcs.dataPtr(), MPI_UNWEIGHTED,
+                                                   dsts.size(), dsts.dataPtr(), MPI_UNWEIGHTED,
+                                                   MPI_INFO_NULL, 0, &m_nbr_comm) );
+    m_nbr_parent = comm;
+#else
+    amrex::Abort("FabArrayBase: neighborhood collectives require MPI-3");
+#endif
+
+    return m_nbr_comm;
+}
+
+MPI_Request
+FabArrayBase::StartNeighborExchange (const CommMetaData& thecmd,
+                                     const char* the_send_data,
+                                     const Vector<char*>& send_data,
+                                     const Vector<std::size_t>& send_size,
+                                     char* the_recv_data,
+                                     const Vector<char*>& recv_data,
+                                     const Vector<std::size_t>& recv_size)
+{
+    MPI_Comm nbr_comm = thecmd.getNeighborComm();
+
+    const int N_snds = send_size.size();
+    const int N_rcvs = recv_size.size();
+
+    // Find the largest unit in which all offsets and sizes are integral
+    // and fit in int.
+    const std::size_t imax = std::numeric_limits<int>::max();
+    auto fits = [&] (std::size_t unit) -> bool
+    {
+        for (int i = 0; i < N_snds; ++i) {
+            std::size_t offset = send_data[i] - the_send_data;
+            if (offset % unit != 0 || send_size[i] % unit != 0 ||
+                (offset + send_size[i]) / unit > imax) {
+                return false;
+            }
+        }
+        for (int i = 0; i < N_rcvs; ++i) {
+            std::size_t offset = recv_data[i] - the_recv_data;
+            if (offset % unit != 0 || recv_size[i] % unit != 0 ||
+                (offset + recv_size[i]) / unit > imax) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::size_t unit;
+    MPI_Datatype dtype;
+    if (fits(1)) {
+        unit = 1;
+        dtype = ParallelDescriptor::Mpi_typemap<char>::type();
+    } else if (fits(sizeof(unsigned long long))) {
+        unit = sizeof(unsigned long long);
+        dtype = ParallelDescriptor::Mpi_typemap<unsigned long long>::type();
+    } else if (fits(sizeof(ParallelDescriptor::lull_t))) {
+        unit = sizeof(ParallelDescriptor::lull_t);
+        dtype = ParallelDescriptor::Mpi_typemap<ParallelDescriptor::lull_t>::type();
+    } else {
+        amrex::Abort("FabArrayBase::StartNeighborExchange: message size is too big");
+        return MPI_REQUEST_NULL;
+    }
+
+    Vector<int> scnts(N_snds), sdispls(N_snds), rcnts(N_rcvs), rdispls(N_rcvs);
+    for (int i = 0; i < N_snds; ++i) {
+        scnts[i] = static_cast<int>(send_size[i] / unit);
+        sdispls[i] = static_cast<int>((send_data[i] - the_send_data) / unit);
+    }
+    for (int i = 0; i < N_rcvs; ++i) {
+        rcnts[i] = static_cast<int>(recv_size[i] / unit);
+        rdispls[i] = static_cast<int>((recv_data[i] - the_recv_data) / unit);
+    }
+
+    MPI_Request req = MPI_REQUEST_NULL;
+#if (MPI_VERSION >= 3)
+    BL_MPI_REQUIRE( MPI_Ineighbor_alltoallv(the_send_data, scnts.dataPtr(), sdispls.dataPtr(), dtype,
+                                            the_recv_data, rcnts.dataPtr(), rdispls.dataPtr(), dtype,
+                                            nbr_comm, &req) );
+#else
+    amrex::ignore_unused(nbr_comm, dtype);
+#endif
+    return req;
+}
+
 #endif
 
 std::ostream&
@@ -1889,6 +2247,16 @@ FabArrayBase::updateMemUsage (std::string const& tag, Long nbytes, Arena const*
     mi.nbytes_hwm = std::max(mi.nbytes, mi.nbytes_hwm);
 }
 
+void
+FabArrayBase::printCacheStats ()
+{
+    m_TAC_stats.print();
+    m_FBC_stats.print();
+    m_CPC_stats.print();
+    m_FPinfo_stats.print();
+    m_CFinfo_stats.print();
+}
+
 void
 FabArrayBase::printMemUsage ()
 {
@@ -1898,7 +2266,59 @@ FabArrayBase::printMemUsage ()
         for (auto const& kv : m_mem_usage) {
             std::cout << kv.first << ": " << kv.second.nbytes << ", " << kv.second.nbytes_hwm << "\n";
         }
+        if (m_numa_sampled_pages > 0) {
+            std::cout << "NUMA first touch: " << m_numa_local_pages << " of "
+                      << m_numa_sampled_pages << " sampled pages on the owning thread's node ("
+                      << (100.*m_numa_local_pages)/m_numa_sampled_pages << "%)\n";
+        }
+    }
+}
+
+std::size_t
+FabArrayBase::pageSize ()
+{
+#ifdef __linux__
+    static const std::size_t page_size = sysconf(_SC_PAGESIZE);
+    return page_size;
+#else
+    return 4096;
+#endif
+}
+
+void
+FabArrayBase::recordPageLocality (Vector<void*> const& pages)
+{
+#if defined(__linux__) && defined(SYS_move_pages) && defined(SYS_getcpu)
+    if (pages.empty()) return;
+
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return;
+
+    // With nodes == nullptr, move_pages only reports where the pages are.
+    Vector<int> status(pages.size(), -1);
+    if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr,
+                status.data(), 0) != 0) {
+        return;
+    }
+
+    Long nlocal = 0, nsampled = 0;
+    for (int st : status) {
+        if (st >= 0) {
+            ++nsampled;
+            if (st == static_cast<int>(node)) ++nlocal;
+        }
     }
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    m_numa_local_pages += nlocal;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    m_numa_sampled_pages += nsampled;
+#else
+    amrex::ignore_unused(pages);
+#endif
 }
 
 Long
@@ -1,5 +1,7 @@
 
+#include <algorithm>
 #include <iostream>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <cstring>
@@ -8,6 +10,7 @@
 #include <AMReX_FabConv.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_FPC.H>
+#include <AMReX_OpenMP.H>
 #include <AMReX_REAL.H>
 #include <AMReX_Utility.H>
 
@@ -906,6 +909,164 @@ operator>> (std::istream&   is,
     return is;
 }
 
+//
+// Fast conversion between IEEE floats and doubles that are in native or
+// reversed byte order.  Each element is swapped and converted in one pass
+// of a loop without branches, which the compiler can vectorize, and large
+// arrays are split among OpenMP threads.  As with PD_fconvert followed by
+// PD_fixdenormals, results that are denormal when the size changes are
+// set to zero.  Unlike PD_fconvert, doubles are rounded to the nearest
+// float, not truncated, and NaNs stay NaNs.
+//
+
+namespace {
+
+template <typename T> struct IeeeBits;
+template <> struct IeeeBits<float>
+{
+    using type = std::uint32_t;
+    static constexpr type exponent_mask = 0x7f800000U;
+};
+template <> struct IeeeBits<double>
+{
+    using type = std::uint64_t;
+    static constexpr type exponent_mask = 0x7ff0000000000000ULL;
+};
+
+inline std::uint32_t byteSwap (std::uint32_t x) noexcept
+{
+    return  (x >> 24)
+          | ((x >> 8) & 0x0000ff00U)
+          | ((x << 8) & 0x00ff0000U)
+          |  (x << 24);
+}
+
+inline std::uint64_t byteSwap (std::uint64_t x) noexcept
+{
+    return (std::uint64_t(byteSwap(static_cast<std::uint32_t>(x))) << 32)
+          | byteSwap(static_cast<std::uint32_t>(x >> 32));
+}
+
+template <typename TI, typename TO, bool SwapIn, bool SwapOut, bool FixDenormals>
+void
+ieeeConvertRange (char* AMREX_RESTRICT out, const char* AMREX_RESTRICT in, Long nitems)
+{
+    using UI = typename IeeeBits<TI>::type;
+    using UO = typename IeeeBits<TO>::type;
+    for (Long i = 0; i < nitems; ++i)
+    {
+        UI u;
+        std::memcpy(&u, in + i*sizeof(TI), sizeof(TI));
+        if (SwapIn) u = byteSwap(u);
+        TI x;
+        std::memcpy(&x, &u, sizeof(TI));
+        TO y = static_cast<TO>(x);
+        UO v;
+        std::memcpy(&v, &y, sizeof(TO));
+        if (FixDenormals) v = ((v & IeeeBits<TO>::exponent_mask) == 0) ? UO(0) : v;
+        if (SwapOut) v = byteSwap(v);
+        std::memcpy(out + i*sizeof(TO), &v, sizeof(TO));
+    }
+}
+
+template <typename TI, typename TO, bool SwapIn, bool SwapOut>
+void
+ieeeConvert (void* out, const void* in, Long nitems)
+{
+    constexpr bool FixDenormals = sizeof(TI) != sizeof(TO);
+    constexpr Long ChunkSize = 65536;
+    const Long nchunks = (nitems + ChunkSize - 1) / ChunkSize;
+    auto pout = static_cast<char*>(out);
+    auto pin  = static_cast<const char*>(in);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for if (nchunks > 1 && ! OpenMP::in_parallel())
+#endif
+    for (Long c = 0; c < nchunks; ++c)
+    {
+        const Long first = c*ChunkSize;
+        const Long n = std::min(ChunkSize, nitems - first);
+        ieeeConvertRange<TI,TO,SwapIn,SwapOut,FixDenormals>(pout + first*sizeof(TO),
+                                                            pin  + first*sizeof(TI), n);
+    }
+}
+
+template <typename TI, typename TO>
+void
+ieeeConvert (void* out, const void* in, Long nitems, bool swapIn, bool swapOut)
+{
+    if (swapIn) {
+        if (swapOut) {
+            ieeeConvert<TI,TO,true,true>(out, in, nitems);
+        } else {
+            ieeeConvert<TI,TO,true,false>(out, in, nitems);
+        }
+    } else {
+        if (swapOut) {
+            ieeeConvert<TI,TO,false,true>(out, in, nitems);
+        } else {
+            ieeeConvert<TI,TO,false,false>(out, in, nitems);
+        }
+    }
+}
+
+//
+// The size of rd if it is an IEEE float or double in native or reversed
+// byte order, and 0 otherwise.
+//
+int
+ieeeSize (const RealDescriptor& rd, bool& swap)
+{
+    const RealDescriptor& rd32 = FPC::Native32RealDescriptor();
+    const RealDescriptor& rd64 = FPC::Native64RealDescriptor();
+    const RealDescriptor* native = nullptr;
+    if (rd.formatarray() == rd32.formatarray()) {
+        native = &rd32;
+    } else if (rd.formatarray() == rd64.formatarray()) {
+        native = &rd64;
+    } else {
+        return 0;
+    }
+    const Vector<int>& ord = rd.orderarray();
+    const Vector<int>& nord = native->orderarray();
+    if (ord.size() != nord.size()) {
+        return 0;
+    }
+    if (ord == nord) {
+        swap = false;
+    } else if (std::equal(ord.begin(), ord.end(), nord.rbegin())) {
+        swap = true;
+    } else {
+        return 0;
+    }
+    return rd.numBytes();
+}
+
+bool
+ieeeConvert (void*                 out,
+             const void*           in,
+             Long                  nitems,
+             const RealDescriptor& ord,
+             const RealDescriptor& ird)
+{
+    bool swapIn(false), swapOut(false);
+    const int nbi = ieeeSize(ird, swapIn);
+    const int nbo = ieeeSize(ord, swapOut);
+    if (nbi == 4 && nbo == 4) {
+        ieeeConvert<float,float>(out, in, nitems, swapIn, swapOut);
+    } else if (nbi == 4 && nbo == 8) {
+        ieeeConvert<float,double>(out, in, nitems, swapIn, swapOut);
+    } else if (nbi == 8 && nbo == 4) {
+        ieeeConvert<double,float>(out, in, nitems, swapIn, swapOut);
+    } else if (nbi == 8 && nbo == 8) {
+        ieeeConvert<double,double>(out, in, nitems, swapIn, swapOut);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}
+
 static
 void
 PD_convert (void*                 out,
@@ -924,23 +1085,13 @@ PD_convert (void*                 out,
         BL_ASSERT(int(n) == nitems);
         memcpy(out, in, n*ord.numBytes());
     }
+    else if (boffs == 0 && ! onescmp && ieeeConvert(out, in, nitems, ord, ird)) {
+        // ---- done
+    }
     else if (ord.formatarray() == ird.formatarray() && boffs == 0 && ! onescmp) {
         permute_real_word_order(out, in, nitems,
                                 ord.order(), ird.order(), ord.numBytes());
     }
-    else if (ird == FPC::NativeRealDescriptor() && ord == FPC::Native32RealDescriptor()) {
-      auto rIn = static_cast<const char*>(in);
-      auto rOut= static_cast<char*>(out);
-      for(Long i(0); i < nitems; ++i) {
-        Real x;
-        float y;
-        std::memcpy(&x, rIn, sizeof(Real));
-        y = static_cast<float>(x);
-        std::memcpy(rOut, &y, sizeof(float));
-        rOut += sizeof(float);
-        rIn += sizeof(Real);
-      }
-    }
     else
     {
         PD_fconvert(out, in, nitems, boffs, ord.format(), ord.order(),
@@ -206,7 +206,20 @@ MFIter::~MFIter ()
 #endif
 
 #ifdef AMREX_USE_GPU
-    if (device_sync) Gpu::synchronize();
+    if (device_sync) {
+        Gpu::synchronize();
+        releaseScratch();
+    } else if (scratchUsed()) {
+        // Kernels still running may use the scratch memory.  Wait only
+        // for the streams of this MFIter.
+        for (int i = 0; i < std::max(streams,1); ++i) {
+            Gpu::Device::setStreamIndex((streams > 0) ? i : -1);
+            Gpu::streamSynchronize();
+        }
+        releaseScratch();
+    }
+#else
+    releaseScratch();
 #endif
 
 #ifdef AMREX_USE_GPU_PRAGMA
@@ -254,7 +267,7 @@ MFIter::Initialize ()
     }
     else
     {
-	const FabArrayBase::TileArray* pta = fabArray.getTileArray(tile_size);
+	const FabArrayBase::TileArray* pta = fabArray.getTileArray(tile_size, &m_cache_guard);
 	
 	index_map            = &(pta->indexMap);
 	local_index_map      = &(pta->localIndexMap);
@@ -481,6 +494,10 @@ MFIter::grownnodaltilebox (int dir, IntVect const& a_ng) const noexcept
 void
 MFIter::operator++ () noexcept
 {
+#ifndef AMREX_USE_GPU
+    releaseScratch();
+#endif
+
 #ifdef _OPENMP
     if (dynamic)
     {
@@ -516,6 +533,22 @@ MFIter::operator++ () noexcept
     }
 }
 
+bool
+MFIter::scratchUsed () const noexcept
+{
+    // The arena may have been finalized since this MFIter was built.
+    return m_scratch_arena && m_scratch_arena == The_Scratch_Arena()
+        && m_scratch_arena->usedSince(m_scratch_mark);
+}
+
+void
+MFIter::releaseScratch () noexcept
+{
+    if (scratchUsed()) {
+        m_scratch_arena->release(m_scratch_mark);
+    }
+}
+
 #ifdef AMREX_USE_GPU_PRAGMA
 Real*
 MFIter::add_reduce_value(Real* val, MFReducer r)
@@ -710,4 +743,127 @@ MFGhostIter::Initialize ()
     tile_array      = &(lta.tileArray);
 }
 
+MFOverlapIter::~MFOverlapIter ()
+{
+    finish();
+}
+
+void
+MFOverlapIter::Initialize (const IntVect& nghost, bool do_tiling)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!OpenMP::in_parallel(),
+                                     "MFOverlapIter cannot be used in OpenMP parallel region");
+
+    const IntVect ts = do_tiling ? FabArrayBase::mfiter_tile_size
+                                 : IntVect(AMREX_D_DECL(1024000,1024000,1024000));
+
+    const int nlocal = fabArray.IndexArray().size();
+    m_boundary_tiles.resize(nlocal);
+
+    auto add_tiles = [&] (const Box& bx, int K, int li) -> int
+    {
+        int n = 0;
+        for (const Box& tbx : BoxList(bx, ts)) {
+            lta.indexMap.push_back(K);
+            lta.localIndexMap.push_back(li);
+            lta.tileArray.push_back(tbx);
+            ++n;
+        }
+        return n;
+    };
+
+    // Interior tiles first
+    for (int li = 0; li < nlocal; ++li) {
+        const int K = fabArray.IndexArray()[li];
+        const Box& interior = amrex::grow(amrex::enclosedCells(fabArray.box(K)), -nghost);
+        if (interior.ok()) {
+            const int n = add_tiles(interior, K, li);
+            for (int i = 0; i < n; ++i) m_order.push_back(m_order.size());
+        }
+    }
+    m_ninterior = m_order.size();
+
+    // Tiles near the fab boundary
+    for (int li = 0; li < nlocal; ++li) {
+        const int K = fabArray.IndexArray()[li];
+        const Box& vbx = amrex::enclosedCells(fabArray.box(K));
+        const Box& interior = amrex::grow(vbx, -nghost);
+        const BoxList& shell = interior.ok() ? amrex::boxDiff(vbx, interior) : BoxList(vbx);
+        for (const Box& b : shell) {
+            const int n0 = lta.tileArray.size();
+            const int n = add_tiles(b, K, li);
+            for (int i = n0; i < n0+n; ++i) m_boundary_tiles[li].push_back(i);
+        }
+    }
+
+    lta.nuse = 0;
+    index_map       = &(lta.indexMap);
+    local_index_map = &(lta.localIndexMap);
+    tile_array      = &(lta.tileArray);
+
+    typ = fabArray.boxArray().ixType();
+
+    beginIndex = 0;
+    endIndex = lta.indexMap.size();
+
+    m_nfabs_left = nlocal;
+    progress(false);
+    while (m_order.empty() && m_nfabs_left > 0) {
+        progress(true);
+    }
+
+    if (m_order.empty()) {
+        finish();
+        currentIndex = endIndex;
+    } else {
+        currentIndex = m_order[0];
+    }
+}
+
+void
+MFOverlapIter::operator++ ()
+{
+#ifndef AMREX_USE_GPU
+    releaseScratch();
+#endif
+
+    ++m_pos;
+    if (m_nfabs_left > 0) {
+        progress(false);
+        while (m_pos == static_cast<int>(m_order.size()) && m_nfabs_left > 0) {
+            progress(true);
+        }
+    }
+
+    if (m_pos < static_cast<int>(m_order.size())) {
+        currentIndex = m_order[m_pos];
+    } else {
+        finish();
+        currentIndex = endIndex;
+    }
+}
+
+void
+MFOverlapIter::progress (bool wait)
+{
+    const Vector<int>& ready = m_poll(wait);
+    for (int li : ready) {
+        m_order.insert(m_order.end(), m_boundary_tiles[li].begin(), m_boundary_tiles[li].end());
+        --m_nfabs_left;
+    }
+    if (wait && ready.empty()) {
+        // Nothing is left to wait for.
+        m_nfabs_left = 0;
+    }
+}
+
+void
+MFOverlapIter::finish ()
+{
+    if (!m_finished) {
+        m_finished = true;
+        m_finish();
+    }
+}
+
 }
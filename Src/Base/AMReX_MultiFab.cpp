@@ -1328,12 +1328,8 @@ MultiFab::OverrideSync (const iMultiFab& msk, const Periodicity& period)
 void
 FillBoundary (Vector<MultiFab*> const& mf, const Periodicity& period)
 {
-    for (auto x : mf) {
-        x->FillBoundary(period);
-    }
-// The following is actually slower on summit
-//    Vector<FabArray<FArrayBox>*> fa{mf.begin(),mf.end()};
-//    FillBoundary(fa,period);
+    Vector<FabArray<FArrayBox>*> fa{mf.begin(),mf.end()};
+    FillBoundary(fa,period);
 }
 
 }
@@ -1,8 +1,15 @@
 
 #include <AMReX_Utility.H>
 #include <AMReX_NFiles.H>
+#include <cerrno>
+#include <cstring>
 #include <deque>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace amrex {
 
 int NFilesIter::currentDeciderIndex(-1);
@@ -571,4 +578,172 @@ void NFilesIter::CleanUpMessages() {
 #endif
 }
 
+
+
+
+NFilesAggregator::NFilesAggregator(int naggregators, const std::string &filename,
+                                   Long stripesize, Long buffersize, MPI_Comm a_comm)
+  : comm(a_comm), fileName(filename), fileSize(0), fileDescriptor(-1)
+{
+  myProc       = ParallelDescriptor::MyProc(comm);
+  nProcs       = ParallelDescriptor::NProcs(comm);
+  naggregators = std::max(1, std::min(nProcs, naggregators));
+  groupSize    = (nProcs + naggregators - 1) / naggregators;
+  nAggregators = (nProcs + groupSize - 1) / groupSize;
+
+  // ---- each piece of the buffer is sent as one message, its size must fit in an int
+  const Long maxMessage(Long(1) << 30);
+  stripeSize = std::max(Long(1), std::min(stripesize, maxMessage));
+  bufferSize = std::max(stripeSize, std::min(buffersize, maxMessage));
+  bufferSize = ((bufferSize + stripeSize - 1) / stripeSize) * stripeSize;
+  if(bufferSize > maxMessage) {
+    bufferSize -= stripeSize;
+  }
+
+  // ---- one rank creates the file, then the aggregators open it
+  if(myProc == 0) {
+    std::ofstream ofs(fileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if( ! ofs.good()) {
+      amrex::FileOpenFailed(fileName);
+    }
+  }
+  ParallelDescriptor::Barrier(comm, "NFilesAggregator");
+
+#ifndef _WIN32
+  if(IsAggregator()) {
+    fileDescriptor = ::open(fileName.c_str(), O_WRONLY);
+    if(fileDescriptor < 0) {
+      amrex::FileOpenFailed(fileName);
+    }
+  }
+#endif
+}
+
+
+NFilesAggregator::~NFilesAggregator()
+{
+#ifndef _WIN32
+  if(fileDescriptor >= 0) {
+    ::close(fileDescriptor);
+  }
+#endif
+}
+
+
+Long NFilesAggregator::Write(const char *data, Long nbytes)
+{
+  BL_PROFILE("NFilesAggregator::Write");
+
+  // ---- every rank finds the offsets of all ranks from their sizes
+  Vector<Long> allBytes(nProcs, 0);
+#ifdef BL_USE_MPI
+  BL_MPI_REQUIRE( MPI_Allgather(&nbytes, 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                allBytes.dataPtr(), 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                comm) );
+#else
+  allBytes[0] = nbytes;
+#endif
+
+  const int myAggregator(Aggregator(myProc));
+  Long myOffset(0), myGroupStart(0), myGroupEnd(0);
+  Long groupStart(((fileSize + stripeSize - 1) / stripeSize) * stripeSize);
+  for(int a(0); a < nProcs; a += groupSize) {
+    Long pos(groupStart);
+    for(int r(a); r < std::min(a + groupSize, nProcs); ++r) {
+      if(r == myProc) {
+        myOffset = pos;
+      }
+      pos += allBytes[r];
+    }
+    if(a == myAggregator) {
+      myGroupStart = groupStart;
+      myGroupEnd   = pos;
+    }
+    fileSize   = pos;
+    groupStart = ((pos + stripeSize - 1) / stripeSize) * stripeSize;
+  }
+
+  const int tag(ParallelDescriptor::SeqNum());
+
+  if(myProc != myAggregator) {
+#ifdef BL_USE_MPI
+    // ---- send in pieces that end where the aggregator's buffer is full
+    Vector<MPI_Request> reqs;
+    Long pos(myOffset - myGroupStart), done(0);
+    while(done < nbytes) {
+      const Long n(std::min(nbytes - done, bufferSize - pos % bufferSize));
+      reqs.push_back(MPI_REQUEST_NULL);
+      BL_MPI_REQUIRE( MPI_Isend(const_cast<char *>(data) + done, static_cast<int>(n), MPI_CHAR,
+                                myAggregator, tag, comm, &reqs.back()) );
+      done += n;
+      pos  += n;
+    }
+    if( ! reqs.empty()) {
+      BL_MPI_REQUIRE( MPI_Waitall(reqs.size(), reqs.dataPtr(), MPI_STATUSES_IGNORE) );
+    }
+#endif
+    return myOffset;
+  }
+
+  buffer.resize(std::min(bufferSize, myGroupEnd - myGroupStart));
+  Long fill(0), bufferStart(myGroupStart);
+  for(int r(myProc); r < std::min(myProc + groupSize, nProcs); ++r) {
+    Long done(0);
+    while(done < allBytes[r]) {
+      const Long n(std::min(allBytes[r] - done, bufferSize - fill));
+      if(r == myProc) {
+        std::memcpy(buffer.dataPtr() + fill, data + done, n);
+      } else {
+#ifdef BL_USE_MPI
+        BL_MPI_REQUIRE( MPI_Recv(buffer.dataPtr() + fill, static_cast<int>(n), MPI_CHAR,
+                                 r, tag, comm, MPI_STATUS_IGNORE) );
+#endif
+      }
+      fill += n;
+      done += n;
+      if(fill == bufferSize) {
+        Flush(bufferStart, buffer.dataPtr(), fill);
+        bufferStart += fill;
+        fill = 0;
+      }
+    }
+  }
+  if(fill > 0) {
+    Flush(bufferStart, buffer.dataPtr(), fill);
+  }
+
+  return myOffset;
+}
+
+
+void NFilesAggregator::Flush(Long fileOffset, const char *data, Long nbytes)
+{
+  BL_PROFILE("NFilesAggregator::Flush");
+#ifndef _WIN32
+  while(nbytes > 0) {
+    const ssize_t n(::pwrite(fileDescriptor, data, nbytes, fileOffset));
+    if(n < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      amrex::Error("NFilesAggregator::Flush:  pwrite failed for " + fileName
+                   + ":  " + std::strerror(errno));
+    }
+    data       += n;
+    nbytes     -= n;
+    fileOffset += n;
+  }
+#else
+  std::fstream fs(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if( ! fs.good()) {
+    amrex::FileOpenFailed(fileName);
+  }
+  fs.seekp(fileOffset, std::ios::beg);
+  fs.write(data, nbytes);
+  if( ! fs.good()) {
+    amrex::Error("NFilesAggregator::Flush:  write failed for " + fileName);
+  }
+#endif
+}
+
 }
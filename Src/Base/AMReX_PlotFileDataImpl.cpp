@@ -1,7 +1,17 @@
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <AMReX_PlotFileDataImpl.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_FPC.H>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace amrex {
 
@@ -96,7 +106,16 @@ PlotFileDataImpl::PlotFileDataImpl (std::string const& plotfile_name)
     }
 }
 
-PlotFileDataImpl::~PlotFileDataImpl () {}
+PlotFileDataImpl::~PlotFileDataImpl ()
+{
+#ifndef _WIN32
+    for (auto const& kv : m_mapped_files) {
+        if (kv.second.data != nullptr) {
+            munmap(kv.second.data, kv.second.size);
+        }
+    }
+#endif
+}
 
 void
 PlotFileDataImpl::syncDistributionMap (PlotFileDataImpl const& src) noexcept
@@ -127,19 +146,164 @@ MultiFab
 PlotFileDataImpl::get (int level, std::string const& varname) noexcept
 {
     MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level]);
+    int icomp = compIndex(varname);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        int gid = mfi.index();
+        FArrayBox& dstfab = mf[mfi];
+        std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
+        dstfab.copy<RunOn::Host>(*srcfab);
+    }
+    return mf;
+}
+
+FArrayBox
+PlotFileDataImpl::getFab (int level, int gid) noexcept
+{
+    return readFab(level, gid, -1);
+}
+
+FArrayBox
+PlotFileDataImpl::getFab (int level, int gid, std::string const& varname) noexcept
+{
+    return readFab(level, gid, compIndex(varname));
+}
+
+FArrayBox
+PlotFileDataImpl::get (int level, Box const& region) noexcept
+{
+    return readRegion(level, region, -1);
+}
+
+FArrayBox
+PlotFileDataImpl::get (int level, Box const& region, std::string const& varname) noexcept
+{
+    return readRegion(level, region, compIndex(varname));
+}
+
+int
+PlotFileDataImpl::compIndex (std::string const& varname) const noexcept
+{
     auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
     if (r == std::end(m_var_names)) {
         amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
+    }
+    return std::distance(std::begin(m_var_names), r);
+}
+
+FArrayBox
+PlotFileDataImpl::readFab (int level, int gid, int icomp, Box const& region) noexcept
+{
+    const Box bx = amrex::grow(m_ba[level][gid], m_ngrow[level]);
+    const int ncomp = (icomp < 0) ? m_ncomp : 1;
+
+    RealDescriptor rd;
+    char* p = mapFab(level, gid, rd);
+    if (p != nullptr) {
+        if (icomp > 0) {
+            p += bx.numPts() * icomp * rd.numBytes();
+        }
+        if (rd == FPC::NativeRealDescriptor() &&
+            reinterpret_cast<std::uintptr_t>(p) % alignof(Real) == 0)
+        {
+            return FArrayBox(bx, ncomp, reinterpret_cast<Real*>(p));
+        }
+        FArrayBox fab(bx, ncomp);
+        RealDescriptor::convertToNativeFormat(fab.dataPtr(), bx.numPts()*ncomp, p, rd);
+        return fab;
+    }
+
+    std::unique_ptr<FArrayBox> fab(region.ok() ? m_vismf[level]->readFAB(gid, icomp, region)
+                                   : (icomp < 0) ? m_vismf[level]->readFAB(gid, m_mf_name[level])
+                                                 : m_vismf[level]->readFAB(gid, icomp));
+    return FArrayBox(std::move(*fab));
+}
+
+FArrayBox
+PlotFileDataImpl::readRegion (int level, Box const& region, int icomp) noexcept
+{
+    const int ncomp = (icomp < 0) ? m_ncomp : 1;
+    FArrayBox r(region, ncomp);
+    r.setVal<RunOn::Host>(0.0);
+    for (auto const& is : m_ba[level].intersections(region)) {
+        FArrayBox src = readFab(level, is.first, icomp, is.second);
+        r.copy<RunOn::Host>(src, is.second, 0, is.second, 0, ncomp);
+    }
+    return r;
+}
+
+char*
+PlotFileDataImpl::mapFab (int level, int gid, RealDescriptor& rd) noexcept
+{
+#ifdef _WIN32
+    amrex::ignore_unused(level, gid, rd);
+    return nullptr;
+#else
+    VisMF::Header const& hdr = m_vismf[level]->header();
+    if (hdr.m_vers == VisMF::Header::Compressed_v1 || hdr.m_vers == VisMF::Header::Indexed_v1) {
+        return nullptr;
+    }
+
+    VisMF::FabOnDisk const& fod = hdr.m_fod[gid];
+    std::string const& mf_name = m_mf_name[level];
+    std::string file_name = mf_name.substr(0, mf_name.rfind('/')+1) + fod.m_name;
+
+    auto it = m_mapped_files.find(file_name);
+    if (it == m_mapped_files.end()) {
+        MappedFile mapped;
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                // Private and writable so that writing to the FABs does not change the file.
+                void* p = mmap(nullptr, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    mapped.data = static_cast<char*>(p);
+                    mapped.size = st.st_size;
+                }
+            }
+            close(fd);
+        }
+        it = m_mapped_files.emplace(file_name, mapped).first;
+    }
+
+    MappedFile const& mapped = it->second;
+    Long offset = fod.m_head;
+    if (mapped.data == nullptr || offset < 0 || offset >= mapped.size) {
+        return nullptr;
+    }
+
+    const Box bx = amrex::grow(m_ba[level][gid], m_ngrow[level]);
+    if (VisMF::NoFabHeader(hdr)) {
+        rd = hdr.m_writtenRD;
     } else {
-        int icomp = std::distance(std::begin(m_var_names), r);
-        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-            int gid = mfi.index();
-            FArrayBox& dstfab = mf[mfi];
-            std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
-            dstfab.copy<RunOn::Host>(*srcfab);
+        // ---- skip the FAB header: FAB RealDescriptor Box nComp
+        constexpr Long max_header_size = 4096;
+        char* line = mapped.data + offset;
+        char* eol = static_cast<char*>(std::memchr(line, '\n',
+                                       std::min(max_header_size, mapped.size-offset)));
+        if (eol == nullptr) {
+            return nullptr;
+        }
+        std::istringstream is(std::string(line, eol));
+        std::string fab;
+        Box fab_box;
+        int nvar;
+        is >> fab;
+        if (fab != "FAB") {  // ---- the "old" FAB format
+            return nullptr;
+        }
+        is >> rd >> fab_box >> nvar;
+        if (is.fail() || fab_box != bx || nvar != m_ncomp) {
+            return nullptr;
         }
+        offset = eol + 1 - mapped.data;
     }
-    return mf;
+
+    if (offset + bx.numPts() * m_ncomp * rd.numBytes() > mapped.size) {
+        return nullptr;
+    }
+    return mapped.data + offset;
+#endif
 }
 
 }
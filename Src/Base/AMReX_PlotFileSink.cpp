@@ -0,0 +1,448 @@
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+#include <AMReX_PlotFileSink.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace amrex {
+
+namespace {
+
+#ifndef _WIN32
+    //! A buffered stream on a file descriptor that it closes.
+    class FdStreamBuf
+        : public std::streambuf
+    {
+    public:
+        explicit FdStreamBuf (int fd) : m_fd(fd), m_buf(1 << 16) {
+            setp(m_buf.data(), m_buf.data() + m_buf.size());
+            setg(m_buf.data(), m_buf.data(), m_buf.data());
+        }
+
+        ~FdStreamBuf () override {
+            sync();
+            ::close(m_fd);
+        }
+
+    protected:
+        int_type overflow (int_type c) override {
+            if (flush() < 0) {
+                return traits_type::eof();
+            }
+            if ( ! traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync () override { return flush(); }
+
+        int_type underflow () override {
+            ssize_t n;
+            do {
+                n = ::read(m_fd, m_buf.data(), m_buf.size());
+            } while (n < 0 && errno == EINTR);
+            if (n <= 0) {
+                return traits_type::eof();
+            }
+            setg(m_buf.data(), m_buf.data(), m_buf.data() + n);
+            return traits_type::to_int_type(*gptr());
+        }
+
+    private:
+        int flush () {
+            const char* p = pbase();
+            while (p < pptr()) {
+                ssize_t n = ::write(m_fd, p, pptr() - p);
+                if (n < 0) {
+                    if (errno == EINTR) { continue; }
+                    return -1;
+                }
+                p += n;
+            }
+            setp(m_buf.data(), m_buf.data() + m_buf.size());
+            return 0;
+        }
+
+        int m_fd;
+        Vector<char> m_buf;
+    };
+
+    sockaddr_un socketAddress (std::string const& socket_path)
+    {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (socket_path.size() >= sizeof(addr.sun_path)) {
+            amrex::Abort("PlotFileSink: socket path too long: " + socket_path);
+        }
+        std::strcpy(addr.sun_path, socket_path.c_str());
+        return addr;
+    }
+#endif
+
+    void GotoNextLine (std::istream& is)
+    {
+        constexpr std::streamsize bl_ignore_max { 100000 };
+        is.ignore(bl_ignore_max, '\n');
+    }
+}
+
+PlotFileStreamSink::PlotFileStreamSink (std::ostream& os)
+    : m_os(&os)
+{}
+
+PlotFileStreamSink::PlotFileStreamSink (std::string const& socket_path)
+{
+#ifdef _WIN32
+    amrex::ignore_unused(socket_path);
+    amrex::Abort("PlotFileStreamSink: sockets are not supported on Windows");
+#else
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        amrex::Abort("PlotFileStreamSink: cannot create socket");
+    }
+    sockaddr_un addr = socketAddress(socket_path);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        amrex::Abort("PlotFileStreamSink: cannot connect to " + socket_path);
+    }
+    m_buf.reset(new FdStreamBuf(fd));
+    m_own_os.reset(new std::ostream(m_buf.get()));
+    m_os = m_own_os.get();
+#endif
+}
+
+PlotFileStreamSink::~PlotFileStreamSink ()
+{
+    // ---- the stream has to go before its buffer
+    m_own_os.reset();
+    m_buf.reset();
+}
+
+void
+PlotFileStreamSink::writeRecord (const char* kind, int lev, int gid, std::string const& payload)
+{
+    *m_os << kind << ' ' << lev << ' ' << gid << ' ' << payload.size() << '\n';
+    m_os->write(payload.data(), payload.size());
+}
+
+void
+PlotFileStreamSink::header (std::string const& text)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        writeRecord("Header", -1, -1, text);
+    }
+}
+
+void
+PlotFileStreamSink::level (int lev, BoxArray const& ba, DistributionMapping const& /*dm*/, int ncomp)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ostringstream os;
+        os << ncomp << '\n';
+        ba.writeOn(os);
+        writeRecord("Level", lev, -1, os.str());
+    }
+}
+
+void
+PlotFileStreamSink::fab (int lev, int gid, FArrayBox const& fab)
+{
+    // ---- the data are native, the consumer is on the same machine
+    std::ostringstream os;
+    os << fab.box() << ' ' << fab.nComp() << '\n';
+    const std::string fab_header = os.str();
+    const Long nbytes = fab.nBytes();
+    *m_os << "FAB " << lev << ' ' << gid << ' ' << fab_header.size() + nbytes << '\n';
+    m_os->write(fab_header.data(), fab_header.size());
+    m_os->write(reinterpret_cast<const char*>(fab.dataPtr()), nbytes);
+}
+
+void
+PlotFileStreamSink::finish ()
+{
+    writeRecord("End", -1, -1, std::string());
+    m_os->flush();
+    if ( ! m_os->good()) {
+        amrex::Abort("PlotFileStreamSink: writing the stream failed");
+    }
+}
+
+
+void
+PlotFileMemorySink::clear ()
+{
+    m_header.clear();
+    m_complete = false;
+    m_ba.clear();
+    m_dmap.clear();
+    m_fabs.clear();
+}
+
+void
+PlotFileMemorySink::header (std::string const& text)
+{
+    clear();
+    parseHeader(text);
+}
+
+void
+PlotFileMemorySink::parseHeader (std::string const& text)
+{
+    m_header = text;
+
+    std::istringstream is(text);
+    std::string file_version;
+    is >> file_version;
+
+    is >> m_ncomp;
+    m_var_names.resize(m_ncomp);
+    for (int i = 0; i < m_ncomp; ++i) {
+        is >> m_var_names[i];
+    }
+
+    is >> m_spacedim >> m_time >> m_finest_level;
+    const int nlevels = m_finest_level+1;
+
+    for (int i = 0; i < m_spacedim; ++i) {
+        is >> m_prob_lo[i];
+    }
+    for (int i = 0; i < m_spacedim; ++i) {
+        is >> m_prob_hi[i];
+    }
+
+    m_ref_ratio.resize(nlevels, 0);
+    for (int i = 0; i < m_finest_level; ++i) {
+        is >> m_ref_ratio[i];
+    }
+    GotoNextLine(is);
+
+    m_prob_domain.resize(nlevels);
+    for (int i = 0; i < nlevels; ++i) {
+        is >> m_prob_domain[i];
+    }
+
+    m_level_steps.resize(nlevels);
+    for (int i = 0; i < nlevels; ++i) {
+        is >> m_level_steps[i];
+    }
+
+    m_cell_size.resize(nlevels, Array<Real,AMREX_SPACEDIM>{{AMREX_D_DECL(1.,1.,1.)}});
+    for (int ilev = 0; ilev < nlevels; ++ilev) {
+        for (int idim = 0; idim < m_spacedim; ++idim) {
+            is >> m_cell_size[ilev][idim];
+        }
+    }
+
+    is >> m_coordsys;
+
+    if (is.fail()) {
+        amrex::Abort("PlotFileMemorySink: cannot parse the plotfile header");
+    }
+
+    resizeLevels(nlevels);
+}
+
+void
+PlotFileMemorySink::resizeLevels (int nlevels)
+{
+    if (m_fabs.size() < nlevels) {
+        m_ba.resize(nlevels);
+        m_dmap.resize(nlevels);
+        m_fabs.resize(nlevels);
+    }
+}
+
+void
+PlotFileMemorySink::level (int lev, BoxArray const& ba, DistributionMapping const& dm, int ncomp)
+{
+    AMREX_ALWAYS_ASSERT(lev >= 0 && lev < m_ba.size() && ncomp == m_ncomp);
+    m_ba[lev] = ba;
+    m_dmap[lev] = dm;
+}
+
+void
+PlotFileMemorySink::fab (int lev, int gid, FArrayBox const& fab)
+{
+    AMREX_ALWAYS_ASSERT(lev >= 0);
+    resizeLevels(lev+1);
+    FArrayBox& dst = m_fabs[lev][gid];
+    dst.resize(fab.box(), fab.nComp());
+    dst.copy<RunOn::Host>(fab);
+}
+
+bool
+PlotFileMemorySink::read (std::istream& is)
+{
+    std::string kind;
+    int lev, gid;
+    Long nbytes;
+    while (is >> kind >> lev >> gid >> nbytes) {
+        GotoNextLine(is);
+        if (kind == "FAB") {
+            // ---- read the data straight into the FAB
+            std::string fab_header;
+            std::getline(is, fab_header);
+            std::istringstream hs(fab_header);
+            Box bx;
+            int ncomp;
+            hs >> bx >> ncomp;
+            const Long fab_bytes = bx.numPts() * ncomp * sizeof(Real);
+            if (hs.fail() || Long(fab_header.size()) + 1 + fab_bytes != nbytes) {
+                amrex::Abort("PlotFileMemorySink::read: bad FAB record, written with a different Real?");
+            }
+            AMREX_ALWAYS_ASSERT(lev >= 0);
+            resizeLevels(lev+1);
+            FArrayBox& fab = m_fabs[lev][gid];
+            fab.resize(bx, ncomp);
+            is.read(reinterpret_cast<char*>(fab.dataPtr()), fab_bytes);
+            if ( ! is.good()) {
+                return false;
+            }
+            continue;
+        }
+
+        std::string payload(nbytes, '\0');
+        is.read(&payload[0], nbytes);
+        if ( ! is.good() && nbytes > 0) {
+            return false;
+        }
+        if (kind == "Header") {
+            // ---- the FABs of other streams may have come first
+            parseHeader(payload);
+        } else if (kind == "Level") {
+            std::istringstream ls(payload);
+            int ncomp;
+            ls >> ncomp;
+            BoxArray ba;
+            ba.readFrom(ls);
+            AMREX_ALWAYS_ASSERT(lev >= 0 && ncomp == m_ncomp);
+            resizeLevels(lev+1);
+            if (m_ba[lev] != ba || m_dmap[lev].size() != ba.size()) {
+                m_ba[lev] = ba;
+                m_dmap[lev].define(ba);
+            }
+        } else if (kind == "End") {
+            m_complete = true;
+            return true;
+        } else {
+            amrex::Abort("PlotFileMemorySink::read: unknown record " + kind);
+        }
+    }
+    return false;
+}
+
+bool
+PlotFileMemorySink::read (std::string const& socket_path, int nstreams)
+{
+#ifdef _WIN32
+    amrex::ignore_unused(socket_path, nstreams);
+    amrex::Abort("PlotFileMemorySink: sockets are not supported on Windows");
+    return false;
+#else
+    int sfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sfd < 0) {
+        amrex::Abort("PlotFileMemorySink: cannot create socket");
+    }
+    sockaddr_un addr = socketAddress(socket_path);
+    ::unlink(socket_path.c_str());
+    if (::bind(sfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(sfd, nstreams) != 0)
+    {
+        ::close(sfd);
+        amrex::Abort("PlotFileMemorySink: cannot listen on " + socket_path);
+    }
+    bool r = true;
+    for (int i = 0; i < nstreams; ++i) {
+        int fd;
+        do {
+            fd = ::accept(sfd, nullptr, nullptr);
+        } while (fd < 0 && errno == EINTR);
+        if (fd < 0) {
+            ::close(sfd);
+            amrex::Abort("PlotFileMemorySink: accept failed on " + socket_path);
+        }
+        FdStreamBuf buf(fd);
+        std::istream is(&buf);
+        r = read(is) && r;
+    }
+    ::close(sfd);
+    ::unlink(socket_path.c_str());
+    m_complete = r;
+    return r;
+#endif
+}
+
+bool
+PlotFileMemorySink::hasFab (int level, int gid) const noexcept
+{
+    return level >= 0 && level < m_fabs.size() && m_fabs[level].count(gid) > 0;
+}
+
+const FArrayBox&
+PlotFileMemorySink::getFab (int level, int gid) const noexcept
+{
+    if ( ! hasFab(level, gid)) {
+        amrex::Abort("PlotFileMemorySink::getFab: FAB not here");
+    }
+    return m_fabs[level].at(gid);
+}
+
+MultiFab
+PlotFileMemorySink::get (int level) const noexcept
+{
+    MultiFab mf(m_ba[level], m_dmap[level], m_ncomp, 0);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        mf[mfi].copy<RunOn::Host>(getFab(level, mfi.index()));
+    }
+    return mf;
+}
+
+MultiFab
+PlotFileMemorySink::get (int level, std::string const& varname) const noexcept
+{
+    MultiFab mf(m_ba[level], m_dmap[level], 1, 0);
+    const int icomp = compIndex(varname);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        mf[mfi].copy<RunOn::Host>(getFab(level, mfi.index()), icomp, 0, 1);
+    }
+    return mf;
+}
+
+FArrayBox
+PlotFileMemorySink::get (int level, Box const& region) const noexcept
+{
+    FArrayBox r(region, m_ncomp);
+    r.setVal<RunOn::Host>(0.0);
+    for (auto const& kv : m_fabs[level]) {
+        const Box bx = kv.second.box() & region;
+        if (bx.ok()) {
+            r.copy<RunOn::Host>(kv.second, bx, 0, bx, 0, m_ncomp);
+        }
+    }
+    return r;
+}
+
+int
+PlotFileMemorySink::compIndex (std::string const& varname) const noexcept
+{
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileMemorySink::get: varname not found "+varname);
+    }
+    return std::distance(std::begin(m_var_names), r);
+}
+
+}
@@ -1,12 +1,16 @@
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include <AMReX_VisMF.H>
 #include <AMReX_AsyncOut.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_FPC.H>
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_MultiFabUtil.H>
 
 #ifdef AMREX_USE_EB
 #include <AMReX_EBFabFactory.H>
@@ -247,6 +251,237 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
     }
 }
 
+void
+WriteMultiLevelPlotfilePreviews (const std::string& plotfilename, int nlevels,
+                                 const Vector<const MultiFab*>& mf,
+                                 const Vector<std::string>& varnames,
+                                 const Vector<Geometry>& geom, Real time,
+                                 const Vector<int>& level_steps,
+                                 const Vector<IntVect>& ref_ratio,
+                                 const Vector<int>& coarsen_ratio,
+                                 const Vector<RealBox>& regions,
+                                 const std::string &versionName,
+                                 const std::string &levelPrefix,
+                                 const std::string &mfPrefix)
+{
+    BL_PROFILE("WriteMultiLevelPlotfilePreviews()");
+
+    BL_ASSERT(nlevels <= mf.size());
+    BL_ASSERT(nlevels <= geom.size());
+    BL_ASSERT(nlevels <= ref_ratio.size()+1);
+    BL_ASSERT(nlevels <= level_steps.size());
+    BL_ASSERT(mf[0]->nComp() == varnames.size());
+
+    const int ncomp = mf[0]->nComp();
+    const Box& domain = geom[0].Domain();
+    const Array<int,AMREX_SPACEDIM> is_per{{AMREX_D_DECL(geom[0].isPeriodic(0),
+                                                         geom[0].isPeriodic(1),
+                                                         geom[0].isPeriodic(2))}};
+
+    if ( ! coarsen_ratio.empty())
+    {
+        //
+        // Level 0 with the data of the finer levels averaged down onto it.
+        //
+        const MultiFab* composite = mf[0];
+        Vector<MultiFab> avg(nlevels-1);
+        for (int level = 0; level < nlevels-1; ++level) {
+            avg[level].define(mf[level]->boxArray(), mf[level]->DistributionMap(), ncomp, 0);
+            MultiFab::Copy(avg[level], *mf[level], 0, 0, ncomp, 0);
+        }
+        for (int level = nlevels-1; level > 0; --level) {
+            const MultiFab& fine = (level == nlevels-1) ? *mf[level] : avg[level];
+            amrex::average_down(fine, avg[level-1], geom[level], geom[level-1],
+                                0, ncomp, ref_ratio[level-1]);
+        }
+        if (nlevels > 1) {
+            composite = &avg[0];
+        }
+
+        for (int r : coarsen_ratio)
+        {
+            const IntVect rr(r);
+            if (r < 1 || ! domain.coarsenable(rr)) {
+                amrex::Abort("WriteMultiLevelPlotfilePreviews: domain not coarsenable by "
+                             + std::to_string(r));
+            }
+
+            BoxArray cba;
+            DistributionMapping cdm;
+            const MultiFab* fine = composite;
+            MultiFab fine_tmp;
+            if (composite->boxArray().coarsenable(rr)) {
+                cba = amrex::coarsen(composite->boxArray(), rr);
+                cdm = composite->DistributionMap();
+            } else {
+                // ---- the grids do not line up with the coarse cells
+                cba = BoxArray(amrex::coarsen(domain, rr));
+                cba.maxSize(32);
+                cdm.define(cba);
+                fine_tmp.define(BoxArray(cba).refine(rr), cdm, ncomp, 0);
+                fine_tmp.ParallelCopy(*composite, 0, 0, ncomp);
+                fine = &fine_tmp;
+            }
+
+            Geometry cgeom(amrex::coarsen(domain, rr), geom[0].ProbDomain(),
+                           geom[0].Coord(), is_per);
+            MultiFab preview(cba, cdm, ncomp, 0);
+            amrex::average_down(*fine, preview, geom[0], cgeom, 0, ncomp, rr);
+
+            WriteSingleLevelPlotfile(plotfilename + "/preview_" + std::to_string(r),
+                                     preview, varnames, cgeom, time, level_steps[0],
+                                     versionName, levelPrefix, mfPrefix);
+        }
+    }
+
+    for (int i = 0; i < regions.size(); ++i)
+    {
+        //
+        // The cells of level 0 that intersect the region, refined for the finer levels.
+        //
+        const Real* dx  = geom[0].CellSize();
+        const Real* plo = geom[0].ProbLo();
+        IntVect lo, hi;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            lo[idim] = static_cast<int>(std::floor((regions[i].lo(idim) - plo[idim]) / dx[idim]));
+            hi[idim] = static_cast<int>(std::ceil ((regions[i].hi(idim) - plo[idim]) / dx[idim])) - 1;
+        }
+        Box rbox = Box(lo, hi) & domain;
+        if ( ! rbox.ok()) {
+            amrex::Abort("WriteMultiLevelPlotfilePreviews: region " + std::to_string(i)
+                         + " does not intersect the domain");
+        }
+        const RealBox rb(rbox, dx, plo);
+
+        Vector<MultiFab> cut;
+        Vector<Geometry> cgeom;
+        for (int level = 0; level < nlevels; ++level)
+        {
+            if (level > 0) {
+                rbox.refine(ref_ratio[level-1]);
+            }
+
+            std::vector<std::pair<int,Box> > isects = mf[level]->boxArray().intersections(rbox);
+            if (isects.empty()) {
+                break;
+            }
+            std::sort(isects.begin(), isects.end(),
+                      [] (std::pair<int,Box> const& a, std::pair<int,Box> const& b)
+                      { return a.first < b.first; });
+
+            // ---- each piece stays with the owner of its grid
+            BoxList bl;
+            Vector<int> pmap, src;
+            for (auto const& is : isects) {
+                bl.push_back(amrex::shift(is.second, -rbox.smallEnd()));
+                pmap.push_back(mf[level]->DistributionMap()[is.first]);
+                src.push_back(is.first);
+            }
+
+            cut.emplace_back(BoxArray(std::move(bl)), DistributionMapping(std::move(pmap)), ncomp, 0);
+            cgeom.emplace_back(amrex::shift(rbox, -rbox.smallEnd()), rb, geom[0].Coord(),
+                               Array<int,AMREX_SPACEDIM>{{AMREX_D_DECL(0,0,0)}});
+
+            const Dim3 off = rbox.smallEnd().dim3();
+            for (MFIter mfi(cut.back()); mfi.isValid(); ++mfi) {
+                const Box& bx = mfi.validbox();
+                auto const& d = cut.back().array(mfi);
+                auto const& s = mf[level]->const_array(src[mfi.index()]);
+                amrex::ParallelFor(bx, ncomp,
+                [=] AMREX_GPU_DEVICE (int ii, int jj, int kk, int n) noexcept
+                {
+                    d(ii,jj,kk,n) = s(ii+off.x, jj+off.y, kk+off.z, n);
+                });
+            }
+        }
+
+        Vector<const MultiFab*> cutp;
+        for (auto const& c : cut) {
+            cutp.push_back(&c);
+        }
+        WriteMultiLevelPlotfile(plotfilename + "/region_" + std::to_string(i),
+                                static_cast<int>(cut.size()), cutp, varnames, cgeom, time,
+                                level_steps, ref_ratio, versionName, levelPrefix, mfPrefix);
+    }
+}
+
+void
+WriteMultiLevelPlotfile (PlotFileSink& sink, int nlevels,
+                         const Vector<const MultiFab*>& mf,
+                         const Vector<std::string>& varnames,
+                         const Vector<Geometry>& geom, Real time,
+                         const Vector<int>& level_steps,
+                         const Vector<IntVect>& ref_ratio,
+                         const std::string &versionName,
+                         const std::string &levelPrefix,
+                         const std::string &mfPrefix)
+{
+    BL_PROFILE("WriteMultiLevelPlotfile(sink)");
+
+    BL_ASSERT(nlevels <= mf.size());
+    BL_ASSERT(nlevels <= geom.size());
+    BL_ASSERT(nlevels <= ref_ratio.size()+1);
+    BL_ASSERT(nlevels <= level_steps.size());
+    BL_ASSERT(mf[0]->nComp() == varnames.size());
+
+    Vector<BoxArray> boxArrays(nlevels);
+    for(int level(0); level < boxArrays.size(); ++level) {
+        boxArrays[level] = mf[level]->boxArray();
+    }
+
+    std::ostringstream HeaderText;
+    WriteGenericPlotfileHeader(HeaderText, nlevels, boxArrays, varnames,
+                               geom, time, level_steps, ref_ratio, versionName,
+                               levelPrefix, mfPrefix);
+    sink.header(HeaderText.str());
+
+    for (int level = 0; level < nlevels; ++level)
+    {
+        const MultiFab& data = *mf[level];
+        sink.level(level, data.boxArray(), data.DistributionMap(), data.nComp());
+
+        bool data_on_device = (data.arena() == The_Arena() or
+                               data.arena() == The_Device_Arena() or
+                               data.arena() == The_Managed_Arena());
+        bool run_on_device = Gpu::inLaunchRegion() and data_on_device;
+
+        for (MFIter mfi(data); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            if (data[mfi].box() == bx and not run_on_device) {
+                sink.fab(level, mfi.index(), data[mfi]);
+            } else {
+                FArrayBox fab(bx, data.nComp(), The_Pinned_Arena());
+                if (run_on_device) {
+                    fab.copy<RunOn::Device>(data[mfi], bx);
+                    Gpu::streamSynchronize();
+                } else {
+                    fab.copy<RunOn::Host>(data[mfi], bx);
+                }
+                sink.fab(level, mfi.index(), fab);
+            }
+        }
+    }
+
+    sink.finish();
+}
+
+void
+WriteSingleLevelPlotfile (PlotFileSink& sink,
+                          const MultiFab& mf, const Vector<std::string>& varnames,
+                          const Geometry& geom, Real time, int level_step,
+                          const std::string &versionName,
+                          const std::string &levelPrefix,
+                          const std::string &mfPrefix)
+{
+    Vector<const MultiFab*> mfarr(1,&mf);
+    Vector<Geometry> geomarr(1,geom);
+    Vector<int> level_steps(1,level_step);
+    Vector<IntVect> ref_ratio;
+
+    WriteMultiLevelPlotfile(sink, 1, mfarr, varnames, geomarr, time,
+                            level_steps, ref_ratio, versionName, levelPrefix, mfPrefix);
+}
+
 // write a plotfile to disk given:
 // -plotfile name
 // -vector of MultiFabs
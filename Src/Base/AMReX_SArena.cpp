@@ -0,0 +1,173 @@
+
+#include <algorithm>
+
+#include <AMReX_SArena.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Gpu.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParallelReduce.H>
+
+namespace amrex {
+
+SArena::SArena (std::size_t chunk_size, ArenaInfo info)
+    : m_chunk(Arena::align(chunk_size == 0 ? DefaultChunkSize : chunk_size)),
+      m_threads(OpenMP::get_max_threads())
+{
+    arena_info = info;
+}
+
+SArena::~SArena ()
+{
+    for (auto& td : m_threads) {
+        for (auto const& c : td.chunks) {
+            deallocate_system(c.first, c.second);
+        }
+    }
+    for (auto& kv : m_extra_threads) {
+        for (auto const& c : kv.second.chunks) {
+            deallocate_system(c.first, c.second);
+        }
+    }
+}
+
+SArena::ThreadData&
+SArena::threadData () noexcept
+{
+    const int tid = OpenMP::get_thread_num();
+    if (tid < static_cast<int>(m_threads.size())) {
+        return m_threads[tid];
+    }
+    // std::map does not move its elements, so the reference stays valid
+    // after the lock is released.
+    std::lock_guard<std::mutex> lock(m_extra_mutex);
+    return m_extra_threads[tid];
+}
+
+SArena::ThreadData const&
+SArena::threadData () const noexcept
+{
+    return const_cast<SArena*>(this)->threadData();
+}
+
+void*
+SArena::alloc (std::size_t nbytes)
+{
+    ThreadData& td = threadData();
+
+    nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
+
+    const int nchunks = td.chunks.size();
+    if (nchunks > 0 && td.offset + nbytes <= td.chunks[td.cur].second) {
+        void* vp = td.chunks[td.cur].first + td.offset;
+        td.offset += nbytes;
+        return vp;
+    }
+    //
+    // Move on to the next chunk that is big enough.  The ones skipped
+    // are reused once the pointer is rewound past them.
+    //
+    for (int i = td.cur+1; i < nchunks; ++i) {
+        if (nbytes <= td.chunks[i].second) {
+            td.cur = i;
+            td.offset = nbytes;
+            return td.chunks[i].first;
+        }
+    }
+    //
+    // Insert a new chunk right after the current one.  Markers can only
+    // refer to chunks up to the current one, so they stay valid.
+    //
+    const std::size_t N = std::max(m_chunk, nbytes);
+    char* p = static_cast<char*>(allocate_system(N));
+    const int pos = (nchunks == 0) ? 0 : td.cur+1;
+    td.chunks.insert(td.chunks.begin()+pos, std::make_pair(p,N));
+    td.cur = pos;
+    td.offset = nbytes;
+    return p;
+}
+
+SArena::Marker
+SArena::mark () const noexcept
+{
+    ThreadData const& td = threadData();
+    Marker m;
+    m.chunk = td.cur;
+    m.offset = td.offset;
+    return m;
+}
+
+void
+SArena::release (Marker const& m) noexcept
+{
+    ThreadData& td = threadData();
+    BL_ASSERT(m.chunk < td.cur || (m.chunk == td.cur && m.offset <= td.offset));
+
+    td.cur = m.chunk;
+    td.offset = m.offset;
+
+    if (td.cur == 0 && td.offset == 0 && td.chunks.size() > 1)
+    {
+        //
+        // Nothing of this thread is in use.  Merge the chunks so that
+        // next time everything fits in one.
+        //
+        std::size_t N = 0;
+        for (auto const& c : td.chunks) {
+            N += c.second;
+            deallocate_system(c.first, c.second);
+        }
+        td.chunks.clear();
+        td.chunks.emplace_back(static_cast<char*>(allocate_system(N)), N);
+    }
+}
+
+std::size_t
+SArena::heap_space_used () const noexcept
+{
+    std::size_t r = 0;
+    for (auto const& td : m_threads) {
+        for (auto const& c : td.chunks) {
+            r += c.second;
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_extra_mutex);
+    for (auto const& kv : m_extra_threads) {
+        for (auto const& c : kv.second.chunks) {
+            r += c.second;
+        }
+    }
+    return r;
+}
+
+void
+SArena::PrintUsage (std::string const& name) const
+{
+    Long min_megabytes = heap_space_used() / (1024*1024);
+    Long max_megabytes = min_megabytes;
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+    ParallelReduce::Min<Long>(min_megabytes, IOProc, ParallelDescriptor::Communicator());
+    ParallelReduce::Max<Long>(max_megabytes, IOProc, ParallelDescriptor::Communicator());
+#ifdef AMREX_USE_MPI
+    amrex::Print() << "[" << name << "]" << " space (MB) allocated spread across MPI: ["
+                   << min_megabytes << " ... " << max_megabytes << "]\n";
+#else
+    amrex::Print() << "[" << name << "]" << " space allocated (MB): " << min_megabytes << "\n";
+#endif
+}
+
+ScratchScope::ScratchScope () noexcept
+    : m_arena(static_cast<SArena*>(The_Scratch_Arena())),
+      m_mark((m_arena) ? m_arena->mark() : SArena::Marker())
+{}
+
+ScratchScope::~ScratchScope ()
+{
+    if (m_arena && m_arena == The_Scratch_Arena() && m_arena->usedSince(m_mark)) {
+#ifdef AMREX_USE_GPU
+        Gpu::streamSynchronize();
+#endif
+        m_arena->release(m_mark);
+    }
+}
+
+}
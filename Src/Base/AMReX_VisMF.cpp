@@ -6,6 +6,8 @@
 #include <cerrno>
 #include <atomic>
 #include <cstdio>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <array>
 #include <memory>
@@ -14,6 +16,7 @@
 #include <AMReX_ccse-mpi.H>
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_VisMFCodec.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_NFiles.H>
 #include <AMReX_FPC.H>
@@ -25,6 +28,7 @@ namespace amrex {
 static const char *TheMultiFabHdrFileSuffix = "_H";
 static const char *FabFileSuffix = "_D_";
 static const char *TheFabOnDiskPrefix = "FabOnDisk:";
+static const char *TheFabHashFileSuffix = "_Hash";
 
 std::map<std::string, VisMF::PersistentIFStream> VisMF::persistentIFStreams;
 
@@ -39,6 +43,11 @@ bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+std::string VisMF::compression("shuffle_lz");
+int VisMF::slabSize(0);
+int VisMF::nAggregators(0);
+Long VisMF::stripeSize(1048576);
+Long VisMF::aggregatorBufferSize(16777216);
 
 Long VisMF::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -51,6 +60,378 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    //
+    // With VisMF::Header::Compressed_v1 a fab on disk is a table of the
+    // sizes of its nComp() blocks, as 8 byte little endian integers,
+    // followed by the blocks.  A block is a method byte and the data of
+    // one component, compressed by the codec or raw if that is smaller.
+    // With VisMF::Header::Indexed_v1 each component is split into blocks
+    // of slab cells in the last direction, there is no table, and the
+    // offsets of the blocks are in the header.
+    //
+    enum : char { BlockRaw = 0, BlockCodec = 1 };
+    constexpr int BlockSizeBytes = 8;
+
+    bool compressedVersion (int vers)
+    {
+        return vers == VisMF::Header::Compressed_v1 || vers == VisMF::Header::Indexed_v1;
+    }
+
+    int numSlabs (const Box& bx, int slab)
+    {
+        const int len(bx.length(AMREX_SPACEDIM-1));
+        return (slab > 0) ? (len + slab - 1) / slab : 1;
+    }
+
+    void putBlockSize (Long n, char* p)
+    {
+        for(int b(0); b < BlockSizeBytes; ++b) {
+            p[b] = static_cast<char>((n >> (8*b)) & 0xff);
+        }
+    }
+
+    Long getBlockSize (const char* p)
+    {
+        Long n(0);
+        for(int b(0); b < BlockSizeBytes; ++b) {
+            n |= Long(static_cast<unsigned char>(p[b])) << (8*b);
+        }
+        return n;
+    }
+
+    //
+    // A hash of the data of a fab for VisMF::WriteIncremental.  It reads
+    // 8 bytes at a time into four independent lanes.
+    //
+    std::uint64_t rotl (std::uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    std::uint64_t hashFab (const FArrayBox& fab)
+    {
+        constexpr std::uint64_t P1 = 0x9E3779B185EBCA87ULL;
+        constexpr std::uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+        const char* p = reinterpret_cast<const char*>(fab.dataPtr());
+        const std::size_t nbytes(fab.nBytes());
+        const std::size_t nwords(nbytes / 8);
+
+        std::uint64_t h[4] = { P1, P2, P1 ^ P2, ~P1 };
+        std::size_t i(0);
+        for( ; i + 4 <= nwords; i += 4) {
+            for(int l(0); l < 4; ++l) {
+                std::uint64_t w;
+                std::memcpy(&w, p + 8*(i+l), 8);
+                h[l] = rotl(h[l] ^ (w * P2), 31) * P1;
+            }
+        }
+        for( ; i < nwords; ++i) {
+            std::uint64_t w;
+            std::memcpy(&w, p + 8*i, 8);
+            h[0] = rotl(h[0] ^ (w * P2), 31) * P1;
+        }
+        if(nbytes > 8*nwords) {
+            std::uint64_t w(0);
+            std::memcpy(&w, p + 8*nwords, nbytes - 8*nwords);
+            h[1] = rotl(h[1] ^ (w * P2), 31) * P1;
+        }
+
+        std::uint64_t r(nbytes * P1);
+        for(int l(0); l < 4; ++l) {
+            r = (r ^ (rotl(h[l], 27) * P2)) * P1;
+        }
+        r ^= r >> 33;
+        r *= P2;
+        r ^= r >> 29;
+        r *= P1;
+        r ^= r >> 32;
+        return r;
+    }
+
+    //
+    // The hashes of all fabs of mf on all ranks [index].
+    //
+    Vector<std::uint64_t> gatherFabHashes (const FabArray<FArrayBox>& mf)
+    {
+        const int nLocal(mf.local_size());
+        Vector<std::uint64_t> localHashes(nLocal);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for(int li = 0; li < nLocal; ++li) {
+            localHashes[li] = hashFab(mf[mf.IndexArray()[li]]);
+        }
+
+        Vector<std::uint64_t> hashes(mf.size(), 0);
+#ifdef BL_USE_MPI
+        const int nProcs(ParallelDescriptor::NProcs());
+        const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+        Vector<int> nmtags(nProcs,0);
+        Vector<int> offset(nProcs,0);
+        for(int i(0), N(mf.size()); i < N; ++i) {
+            ++nmtags[pmap[i]];
+        }
+        for(int i(1); i < nProcs; ++i) {
+            offset[i] = offset[i-1] + nmtags[i-1];
+        }
+        if(localHashes.empty()) {
+            // Can't let localHashes be empty as localHashes.dataPtr() will fail.
+            localHashes.resize(1);
+        }
+        Vector<std::uint64_t> recvdata(mf.size());
+        BL_MPI_REQUIRE( MPI_Allgatherv(localHashes.dataPtr(), nLocal, MPI_UINT64_T,
+                                       recvdata.dataPtr(), nmtags.dataPtr(), offset.dataPtr(),
+                                       MPI_UINT64_T, ParallelDescriptor::Communicator()) );
+        Vector<int> cnt(nProcs,0);
+        for(int j(0), N(mf.size()); j < N; ++j) {
+            const int i(pmap[j]);
+            hashes[j] = recvdata[offset[i]+cnt[i]];
+            ++cnt[i];
+        }
+#else
+        for(int li(0); li < nLocal; ++li) {
+            hashes[mf.IndexArray()[li]] = localHashes[li];
+        }
+#endif
+        return hashes;
+    }
+
+    //
+    // Split a path into its directories, removing "." and resolving ".."
+    // where it follows a directory.
+    //
+    Vector<std::string> splitPath (const std::string& path)
+    {
+        Vector<std::string> parts;
+        std::size_t pos(0);
+        while(pos <= path.size()) {
+            std::size_t next(path.find('/', pos));
+            if(next == std::string::npos) {
+                next = path.size();
+            }
+            const std::string part(path.substr(pos, next - pos));
+            if(part == "..") {
+                if( ! parts.empty() && parts.back() != "..") {
+                    parts.pop_back();
+                } else {
+                    parts.push_back(part);
+                }
+            } else if( ! part.empty() && part != ".") {
+                parts.push_back(part);
+            }
+            pos = next + 1;
+        }
+        return parts;
+    }
+
+    std::string joinPath (const Vector<std::string>& parts)
+    {
+        std::string path;
+        const int nparts(parts.size());
+        for(int i(0); i < nparts; ++i) {
+            path += parts[i];
+            if(i + 1 < nparts) {
+                path += '/';
+            }
+        }
+        return path;
+    }
+
+    //
+    // The path of file, relative to directory fromDir, if file is relative
+    // to dir toDir.  Both directories are relative to the same directory,
+    // or both are absolute.  Returns false if that cannot be found.
+    //
+    bool relativePath (const std::string& fromDir, const std::string& toDir,
+                       const std::string& file, std::string& result)
+    {
+        if( ! file.empty() && file[0] == '/') {
+            result = file;
+            return true;
+        }
+        const bool absolute( ! toDir.empty() && toDir[0] == '/');
+        if(absolute != ( ! fromDir.empty() && fromDir[0] == '/')) {
+            return false;
+        }
+        const Vector<std::string> from(splitPath(fromDir));
+        const Vector<std::string> to(splitPath(toDir + "/" + file));
+        const int nfrom(from.size()), nto(to.size());
+        int common(0);
+        while(common < nfrom && common + 1 < nto && from[common] == to[common]) {
+            ++common;
+        }
+        Vector<std::string> parts;
+        for(int i(common); i < nfrom; ++i) {
+            if(from[i] == "..") {
+                return false;
+            }
+            parts.push_back("..");
+        }
+        for(int i(common); i < nto; ++i) {
+            parts.push_back(to[i]);
+        }
+        result = joinPath(parts);
+        return true;
+    }
+
+    //
+    // Append the blocks of fab to out and their sizes to blockSizes,
+    // component by component and slab by slab.  Without a codec the
+    // blocks are raw.
+    //
+    void compressBlocks (const FArrayBox& fab, const RealDescriptor& rd,
+                         const VisMFCodec* codec, int slab,
+                         Vector<char>& out, Vector<Long>& blockSizes)
+    {
+        const bool doConvert(rd != FPC::NativeRealDescriptor());
+        const bool nativeFP(! doConvert || rd == FPC::Native32RealDescriptor());
+        const Box& bx = fab.box();
+        const Long npts(bx.numPts());
+        const int  len(bx.length(AMREX_SPACEDIM-1));
+        const Long planePts(npts / len);
+        const int  nslabs(numSlabs(bx, slab));
+        const int  rdBytes(rd.numBytes());
+
+        Vector<char> converted(doConvert ? npts * rdBytes : 0), block;
+        for(int n(0); n < fab.nComp(); ++n) {
+            const char *comp = reinterpret_cast<const char *>(fab.dataPtr(n));
+            if(doConvert) {
+                RealDescriptor::convertFromNativeFormat(converted.data(), npts, comp, rd);
+                comp = converted.data();
+            }
+            for(int is(0); is < nslabs; ++is) {
+                const int  planes((nslabs == 1) ? len : std::min(slab, len - is*slab));
+                const Long nelems(planes * planePts);
+                const Long nbytes(nelems * rdBytes);
+                const char *src = comp + is * slab * planePts * rdBytes;
+                block.clear();
+                if(codec != nullptr) {
+                    block.push_back(BlockCodec);
+                    codec->compress(src, nelems, rdBytes, nativeFP, block);
+                }
+                if(codec == nullptr || block.size() > nbytes) {
+                    block.clear();
+                    block.push_back(BlockRaw);
+                    block.insert(block.end(), src, src + nbytes);
+                }
+                out.insert(out.end(), block.begin(), block.end());
+                blockSizes.push_back(block.size());
+            }
+        }
+    }
+
+    //
+    // Decode a block of nelems elements into native Reals at dst.
+    //
+    void decompressBlock (const Vector<char>& block, Real* dst, Long nelems,
+                          const VisMF::Header& hdr, Vector<char>& converted)
+    {
+        const RealDescriptor& rd = hdr.m_writtenRD;
+        const bool doConvert(rd != FPC::NativeRealDescriptor());
+        const Long nbytes(nelems * rd.numBytes());
+        if(block.empty()) {
+            amrex::Error("VisMF: read of compressed fab failed");
+        }
+        if(doConvert) {
+            converted.resize(nbytes);
+        }
+        char *raw = doConvert ? converted.data() : reinterpret_cast<char *>(dst);
+        if(block[0] == BlockRaw) {
+            if(Long(block.size()) - 1 != nbytes) {
+                amrex::Error("VisMF: bad size of uncompressed block");
+            }
+            std::memcpy(raw, block.data() + 1, nbytes);
+        } else {
+            const VisMFCodec *codec = VisMFCodec::Find(hdr.m_codec);
+            if(codec == nullptr) {
+                amrex::Error("VisMF: unknown compression codec " + hdr.m_codec);
+            }
+            codec->decompress(block.data() + 1, block.size() - 1, raw, nelems, rd.numBytes());
+        }
+        if(doConvert) {
+            RealDescriptor::convertToNativeFormat(dst, nelems, raw, rd);
+        }
+    }
+
+    void readBlock (std::istream& is, Long nbytes, Vector<char>& block)
+    {
+        block.resize(nbytes);
+        is.read(block.data(), nbytes);
+        if( ! is.good()) {
+            amrex::Error("VisMF: read of compressed fab failed");
+        }
+    }
+
+    //
+    // Read a Compressed_v1 fab from is, positioned at its start, into fab.
+    // If whichComp is -1 all components are read, otherwise only whichComp
+    // is read into component 0.
+    //
+    void decompressFab (std::istream& is, const VisMF::Header& hdr,
+                        FArrayBox& fab, int whichComp)
+    {
+        Vector<char> table(hdr.m_ncomp * BlockSizeBytes);
+        is.read(table.data(), table.size());
+        Vector<Long> blockSize(hdr.m_ncomp);
+        for(int n(0); n < hdr.m_ncomp; ++n) {
+            blockSize[n] = getBlockSize(table.data() + n * BlockSizeBytes);
+        }
+
+        int compLo(0), compHi(hdr.m_ncomp - 1);
+        if(whichComp != -1) {
+            Long skip(0);
+            for(int n(0); n < whichComp; ++n) {
+                skip += blockSize[n];
+            }
+            is.seekg(skip, std::ios::cur);
+            compLo = compHi = whichComp;
+        }
+
+        Vector<char> block, converted;
+        for(int n(compLo); n <= compHi; ++n) {
+            readBlock(is, blockSize[n], block);
+            decompressBlock(block, fab.dataPtr(n - compLo), fab.box().numPts(), hdr, converted);
+        }
+    }
+
+    //
+    // Read the slabs of an Indexed_v1 fab that fab.box() covers, seeking
+    // with the offsets in the header.  fab.box() must be made of whole
+    // slabs.  If whichComp is -1 all components are read, otherwise only
+    // whichComp is read into component 0.
+    //
+    void readIndexedFab (std::istream& is, const VisMF::Header& hdr, int idx,
+                         FArrayBox& fab, int whichComp)
+    {
+        const Box fabBox = amrex::grow(hdr.m_ba[idx], hdr.m_ngrow);
+        const int dir(AMREX_SPACEDIM-1);
+        const int nslabs(numSlabs(fabBox, hdr.m_slab));
+        const int slab((nslabs == 1) ? fabBox.length(dir) : hdr.m_slab);
+        const Long planePts(fabBox.numPts() / fabBox.length(dir));
+        const int sLo((fab.box().smallEnd(dir) - fabBox.smallEnd(dir)) / slab);
+        const int sHi((fab.box().bigEnd(dir)   - fabBox.smallEnd(dir)) / slab);
+        const Vector<Long>& offsets = hdr.m_block_offsets[idx];
+        BL_ASSERT(offsets.size() == hdr.m_ncomp * nslabs + 1);
+
+        int compLo(0), compHi(hdr.m_ncomp - 1);
+        if(whichComp != -1) {
+            compLo = compHi = whichComp;
+        }
+
+        Vector<char> block, converted;
+        for(int n(compLo); n <= compHi; ++n) {
+            Real *dst = fab.dataPtr(n - compLo);
+            for(int s(sLo); s <= sHi; ++s) {
+                const int b(n * nslabs + s);
+                const int planes(std::min(slab, fabBox.length(dir) - s*slab));
+                is.seekg(hdr.m_fod[idx].m_head + offsets[b], std::ios::beg);
+                readBlock(is, offsets[b+1] - offsets[b], block);
+                decompressBlock(block, dst, planes * planePts, hdr, converted);
+                dst += planes * planePts;
+            }
+        }
+    }
 }
 
 void
@@ -88,6 +469,16 @@ VisMF::Initialize ()
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
 
+    pp.query("compression", compression);
+    pp.query("slab_size", slabSize);
+    pp.query("aggregators", nAggregators);
+    pp.query("stripe_size", stripeSize);
+    pp.query("aggregator_buffer_size", aggregatorBufferSize);
+    double absError(0.0), relError(1.e-5);
+    pp.query("compression_abs_error", absError);
+    pp.query("compression_rel_error", relError);
+    VisMFCodec::Register(VisMFCompression::makeQuantizeCodec(absError, relError));
+
     initialized = true;
 }
 
@@ -291,7 +682,8 @@ operator<< (std::ostream        &os,
       os << hd.m_max      << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 || compressedVersion(hd.m_vers))
+    {
       BL_ASSERT(hd.m_famin.size() == hd.m_ncomp);
       BL_ASSERT(hd.m_famin.size() == hd.m_famax.size());
       for(int i(0); i < hd.m_famin.size(); ++i) {
@@ -304,9 +696,7 @@ operator<< (std::ostream        &os,
       os << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(VisMF::NoFabHeader(hd))
     {
       if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
         os << FPC::NativeRealDescriptor() << '\n';
@@ -317,6 +707,21 @@ operator<< (std::ostream        &os,
       }
     }
 
+    if(compressedVersion(hd.m_vers)) {
+      os << hd.m_codec << '\n';
+    }
+
+    if(hd.m_vers == VisMF::Header::Indexed_v1) {
+      os << hd.m_slab << '\n';
+      for(const auto& offsets : hd.m_block_offsets) {
+        os << offsets.size();
+        for(Long off : offsets) {
+          os << ' ' << off;
+        }
+        os << '\n';
+      }
+    }
+
     os.flags(oflags);
     os.precision(oldPrec);
 
@@ -377,7 +782,8 @@ operator>> (std::istream  &is,
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 || compressedVersion(hd.m_vers))
+    {
       char ch;
       hd.m_famin.resize(hd.m_ncomp);
       hd.m_famax.resize(hd.m_ncomp);
@@ -394,13 +800,28 @@ operator>> (std::istream  &is,
 	}
       }
     }
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(VisMF::NoFabHeader(hd))
     {
       is >> hd.m_writtenRD;
     }
 
+    if(compressedVersion(hd.m_vers)) {
+      is >> hd.m_codec;
+    }
+
+    if(hd.m_vers == VisMF::Header::Indexed_v1) {
+      is >> hd.m_slab;
+      hd.m_block_offsets.resize(hd.m_ba.size());
+      for(auto& offsets : hd.m_block_offsets) {
+        Long n;
+        is >> n;
+        offsets.resize(n);
+        for(Long& off : offsets) {
+          is >> off;
+        }
+      }
+    }
+
 
     if( ! is.good()) {
         amrex::Error("Read of VisMF::Header failed");
@@ -562,6 +983,14 @@ VisMF::readFAB (int idx,
     return VisMF::readFAB(idx, m_fafabname, m_hdr, ncomp);
 }
 
+FArrayBox*
+VisMF::readFAB (int idx,
+                int ncomp,
+                const Box& region)
+{
+    return VisMF::readFAB(idx, m_fafabname, m_hdr, ncomp, region);
+}
+
 std::string
 VisMF::BaseName (const std::string& filename)
 {
@@ -673,7 +1102,16 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
              mf.arena() == The_Device_Arena() or
              mf.arena() == The_Managed_Arena());
 
-    if(version == NoFabHeaderFAMinMax_v1) {
+    if(compressedVersion(version)) {
+      m_codec = VisMF::compression;
+    }
+
+    if(version == Indexed_v1) {
+      m_slab = VisMF::slabSize;
+      m_block_offsets.resize(m_ba.size());
+    }
+
+    if(version == NoFabHeaderFAMinMax_v1 || compressedVersion(version)) {
       // ---- calculate FabArray min max values only
       m_min.clear();
       m_max.clear();
@@ -943,6 +1381,29 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
               const std::string& mf_name,
               VisMF::How         how,
               bool               set_ghost)
+{
+    return VisMF::WriteDoit(mf, mf_name, how, set_ghost, false, std::string());
+}
+
+
+Long
+VisMF::WriteIncremental (const FabArray<FArrayBox>&    mf,
+                         const std::string& mf_name,
+                         const std::string& ref_name,
+                         VisMF::How         how,
+                         bool               set_ghost)
+{
+    return VisMF::WriteDoit(mf, mf_name, how, set_ghost, true, ref_name);
+}
+
+
+Long
+VisMF::WriteDoit (const FabArray<FArrayBox>&    mf,
+                  const std::string& mf_name,
+                  VisMF::How         how,
+                  bool               set_ghost,
+                  bool               incremental,
+                  const std::string& ref_name)
 {
     BL_PROFILE("VisMF::Write(FabArray)");
     BL_ASSERT(mf_name[mf_name.length() - 1] != '/');
@@ -1019,96 +1480,208 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
 
-    if(useSparseFPP) {
-        nfi.SetSparseFPP(procsWithDataVector);
-    } else if(useDynamicSetSelection) {
-        nfi.SetDynamic();
-    }
-    for( ; nfi.ReadyToWrite(); ++nfi) {
-        // ---- find the total number of bytes including fab headers if needed
-        const FABio &fio = FArrayBox::getFABio();
-        int whichRDBytes(whichRD->numBytes()), nFABs(0);
-        Long writeDataItems(0), writeDataSize(0);
-        for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
-            const FArrayBox &fab = mf[mfi];
-            if(oldHeader) {
-                std::stringstream hss;
-                fio.write_header(hss, fab, fab.nComp());
-                bytesWritten += static_cast<std::streamoff>(hss.tellp());
+    // ---- for incremental writes, find the fabs that changed since ref_name
+    Vector<std::uint64_t> fabHashes;
+    Vector<char> writeFab;      // ---- [index], empty means all
+    VisMF::Header refHdr;
+    bool writeData(true);
+    if(incremental) {
+      fabHashes = gatherFabHashes(mf);
+      Vector<std::uint64_t> refHashes;
+      if( ! ref_name.empty()) {
+        Vector<char> hashChars, hdrChars;
+        ParallelDescriptor::ReadAndBcastFile(ref_name + TheFabHashFileSuffix, hashChars, false);
+        if( ! hashChars.empty()) {
+          ParallelDescriptor::ReadAndBcastFile(ref_name + TheMultiFabHdrFileSuffix, hdrChars);
+          std::istringstream his(hashChars.dataPtr());
+          std::istringstream ris(hdrChars.dataPtr());
+          int nHashes(0);
+          RealDescriptor refRD;
+          his >> nHashes >> refRD;
+          ris >> refHdr;
+          std::string relName;
+          if(nHashes == mf.size() && refRD == *whichRD &&
+             relativePath(VisMF::DirName(mf_name), VisMF::DirName(ref_name), "f", relName) &&
+             refHdr.m_vers == currentVersion && refHdr.m_ba == mf.boxArray() &&
+             refHdr.m_ncomp == mf.nComp() && refHdr.m_ngrow == mf.nGrowVect() &&
+             refHdr.m_codec == hdr.m_codec && refHdr.m_slab == hdr.m_slab)
+          {
+            refHashes.resize(nHashes);
+            his >> std::hex;
+            for(auto &h : refHashes) {
+              his >> h;
             }
-            bytesWritten += fab.box().numPts() * mf.nComp() * whichRDBytes;
-            ++nFABs;
-        }
-        char *allFabData(nullptr);
-        bool canCombineFABs(false);
-        if((nFABs > 1 || doConvert) && VisMF::useSingleWrite) {
-            allFabData = new(std::nothrow) char[bytesWritten];
-        }    // ---- else { no need to make a copy for one fab }
-        if(allFabData == nullptr) {
-            canCombineFABs = false;
-        } else {
-            canCombineFABs = true;
+          }
         }
+      }
+      if( ! refHashes.empty()) {
+        writeFab.resize(mf.size());
+        writeData = false;
+        for(int i(0); i < mf.size(); ++i) {
+          writeFab[i] = (fabHashes[i] != refHashes[i]);
+          writeData = writeData || writeFab[i];
+        }
+      }
+    }
 
-        if(canCombineFABs) {
-            Long writePosition(0);
-            for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                int hLength(0);
-                const FArrayBox &fab = mf[mfi];
-                writeDataItems = fab.box().numPts() * mf.nComp();
-                writeDataSize = writeDataItems * whichRDBytes;
-                char *afPtr = allFabData + writePosition;
-                if(oldHeader) {
-                    std::stringstream hss;
-                    fio.write_header(hss, fab, fab.nComp());
-                    hLength = static_cast<std::streamoff>(hss.tellp());
-                    auto tstr = hss.str();
-                    memcpy(afPtr, tstr.c_str(), hLength);  // ---- the fab header
-                }
-                if(doConvert) {
-                    RealDescriptor::convertFromNativeFormat(static_cast<void *> (afPtr + hLength),
-                                                            writeDataItems,
-                                                            fab.dataPtr(), *whichRD);
-                } else {    // ---- copy from the fab
-                    memcpy(afPtr + hLength, fab.dataPtr(), writeDataSize);
+    // ---- compress all local fabs before writing
+    bool compressed(compressedVersion(currentVersion));
+    Vector<Vector<char> > compressedFabs;
+    Vector<Vector<Long> > blockSizes;
+    Vector<Long> compressedBytes;
+    if(compressed) {
+      const VisMFCodec *codec = nullptr;
+      if(compression != "none") {
+        codec = VisMFCodec::Find(compression);
+        if(codec == nullptr) {
+          amrex::Abort("VisMF::Write:  unknown vismf.compression " + compression);
+        }
+      }
+      const int nLocal(mf.local_size());
+      const bool table(currentVersion == VisMF::Header::Compressed_v1);
+      const int slab(table ? 0 : hdr.m_slab);
+      compressedFabs.resize(nLocal);
+      blockSizes.resize(nLocal);
+      compressedBytes.resize(nLocal);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for(int li = 0; li < nLocal; ++li) {
+        if( ! writeFab.empty() && ! writeFab[mf.IndexArray()[li]]) {
+          continue;
+        }
+        const FArrayBox &fab = mf[mf.IndexArray()[li]];
+        Vector<char> &out = compressedFabs[li];
+        if(table) {
+          out.resize(fab.nComp() * BlockSizeBytes);
+        }
+        compressBlocks(fab, *whichRD, codec, slab, out, blockSizes[li]);
+        if(table) {
+          for(int n(0); n < fab.nComp(); ++n) {
+            putBlockSize(blockSizes[li][n], out.data() + n * BlockSizeBytes);
+          }
+        }
+        compressedBytes[li] = out.size();
+      }
+    }
+
+    bool aggregate(nAggregators > 0);
+    if( ! writeData) {
+        // ---- nothing changed, the header refers to ref_name for all fabs
+    } else if(aggregate) {
+        bytesWritten += VisMF::WriteAggregated(mf, filePrefix, hdr, *whichRD, compressedFabs,
+                                               coordinatorProc,
+                                               ParallelDescriptor::Communicator(), writeFab);
+    } else {
+        if(useSparseFPP) {
+            nfi.SetSparseFPP(procsWithDataVector);
+        } else if(useDynamicSetSelection) {
+            nfi.SetDynamic();
+        }
+        for( ; nfi.ReadyToWrite(); ++nfi) {
+            if(compressed) {
+                for(int li(0); li < compressedFabs.size(); ++li) {
+                    nfi.Stream().write(compressedFabs[li].data(), compressedFabs[li].size());
+                    bytesWritten += compressedFabs[li].size();
                 }
-                writePosition += hLength + writeDataSize;
+                nfi.Stream().flush();
+                continue;
             }
-            nfi.Stream().write(allFabData, bytesWritten);
-            nfi.Stream().flush();
-            delete [] allFabData;
 
-        } else {    // ---- write fabs individually
+            // ---- find the total number of bytes including fab headers if needed
+            const FABio &fio = FArrayBox::getFABio();
+            int whichRDBytes(whichRD->numBytes()), nFABs(0);
+            Long writeDataItems(0), writeDataSize(0);
             for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                int hLength(0);
+                if( ! writeFab.empty() && ! writeFab[mfi.index()]) {
+                    continue;
+                }
                 const FArrayBox &fab = mf[mfi];
-                writeDataItems = fab.box().numPts() * mf.nComp();
-                writeDataSize = writeDataItems * whichRDBytes;
                 if(oldHeader) {
                     std::stringstream hss;
                     fio.write_header(hss, fab, fab.nComp());
-                    hLength = static_cast<std::streamoff>(hss.tellp());
-                    auto tstr = hss.str();
-                    nfi.Stream().write(tstr.c_str(), hLength);    // ---- the fab header
-                    nfi.Stream().flush();
+                    bytesWritten += static_cast<std::streamoff>(hss.tellp());
+                }
+                bytesWritten += fab.box().numPts() * mf.nComp() * whichRDBytes;
+                ++nFABs;
+            }
+            char *allFabData(nullptr);
+            bool canCombineFABs(false);
+            if((nFABs > 1 || doConvert) && VisMF::useSingleWrite) {
+                allFabData = new(std::nothrow) char[bytesWritten];
+            }    // ---- else { no need to make a copy for one fab }
+            if(allFabData == nullptr) {
+                canCombineFABs = false;
+            } else {
+                canCombineFABs = true;
+            }
+
+            if(canCombineFABs) {
+                Long writePosition(0);
+                for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                    if( ! writeFab.empty() && ! writeFab[mfi.index()]) {
+                        continue;
+                    }
+                    int hLength(0);
+                    const FArrayBox &fab = mf[mfi];
+                    writeDataItems = fab.box().numPts() * mf.nComp();
+                    writeDataSize = writeDataItems * whichRDBytes;
+                    char *afPtr = allFabData + writePosition;
+                    if(oldHeader) {
+                        std::stringstream hss;
+                        fio.write_header(hss, fab, fab.nComp());
+                        hLength = static_cast<std::streamoff>(hss.tellp());
+                        auto tstr = hss.str();
+                        memcpy(afPtr, tstr.c_str(), hLength);  // ---- the fab header
+                    }
+                    if(doConvert) {
+                        RealDescriptor::convertFromNativeFormat(static_cast<void *> (afPtr + hLength),
+                                                                writeDataItems,
+                                                                fab.dataPtr(), *whichRD);
+                    } else {    // ---- copy from the fab
+                        memcpy(afPtr + hLength, fab.dataPtr(), writeDataSize);
+                    }
+                    writePosition += hLength + writeDataSize;
                 }
-                if(doConvert) {
-                    char *cDataPtr = new char[writeDataSize];
-                    RealDescriptor::convertFromNativeFormat(static_cast<void *> (cDataPtr),
-                                                            writeDataItems,
-                                                            fab.dataPtr(), *whichRD);
-                    nfi.Stream().write(cDataPtr, writeDataSize);
-                    nfi.Stream().flush();
-                    delete [] cDataPtr;
-                } else {    // ---- copy from the fab
-                    nfi.Stream().write((char *) fab.dataPtr(), writeDataSize);
-                    nfi.Stream().flush();
+                nfi.Stream().write(allFabData, bytesWritten);
+                nfi.Stream().flush();
+                delete [] allFabData;
+
+            } else {    // ---- write fabs individually
+                for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                    if( ! writeFab.empty() && ! writeFab[mfi.index()]) {
+                        continue;
+                    }
+                    int hLength(0);
+                    const FArrayBox &fab = mf[mfi];
+                    writeDataItems = fab.box().numPts() * mf.nComp();
+                    writeDataSize = writeDataItems * whichRDBytes;
+                    if(oldHeader) {
+                        std::stringstream hss;
+                        fio.write_header(hss, fab, fab.nComp());
+                        hLength = static_cast<std::streamoff>(hss.tellp());
+                        auto tstr = hss.str();
+                        nfi.Stream().write(tstr.c_str(), hLength);    // ---- the fab header
+                        nfi.Stream().flush();
+                    }
+                    if(doConvert) {
+                        char *cDataPtr = new char[writeDataSize];
+                        RealDescriptor::convertFromNativeFormat(static_cast<void *> (cDataPtr),
+                                                                writeDataItems,
+                                                                fab.dataPtr(), *whichRD);
+                        nfi.Stream().write(cDataPtr, writeDataSize);
+                        nfi.Stream().flush();
+                        delete [] cDataPtr;
+                    } else {    // ---- copy from the fab
+                        nfi.Stream().write((char *) fab.dataPtr(), writeDataSize);
+                        nfi.Stream().flush();
+                    }
                 }
             }
         }
     }
 
-    if(nfi.GetDynamic()) {
+    if(writeData && ! aggregate && nfi.GetDynamic()) {
         coordinatorProc = nfi.CoordinatorProc();
     }
 
@@ -1122,8 +1695,40 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
-    VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
-                       ParallelDescriptor::Communicator());
+    if(writeData && ! aggregate) {
+      VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
+                         ParallelDescriptor::Communicator(), compressedBytes, writeFab);
+    }
+
+    if(writeData && currentVersion == VisMF::Header::Indexed_v1) {
+        VisMF::GatherBlockOffsets(mf, hdr, blockSizes, coordinatorProc,
+                                  ParallelDescriptor::Communicator(), writeFab);
+    }
+
+    if(incremental && ParallelDescriptor::MyProc() == coordinatorProc) {
+      // ---- the unchanged fabs are in the files of ref_name
+      for(int i(0); i < mf.size(); ++i) {
+        if( ! writeFab.empty() && ! writeFab[i]) {
+          std::string fileName;
+          relativePath(VisMF::DirName(mf_name), VisMF::DirName(ref_name),
+                       refHdr.m_fod[i].m_name, fileName);
+          hdr.m_fod[i] = VisMF::FabOnDisk(fileName, refHdr.m_fod[i].m_head);
+          if(currentVersion == VisMF::Header::Indexed_v1) {
+            hdr.m_block_offsets[i] = refHdr.m_block_offsets[i];
+          }
+        }
+      }
+
+      const std::string hashFileName(mf_name + TheFabHashFileSuffix);
+      std::ofstream hashFile(hashFileName.c_str(), std::ios::out | std::ios::trunc);
+      if( ! hashFile.good()) {
+        amrex::FileOpenFailed(hashFileName);
+      }
+      hashFile << mf.size() << '\n' << *whichRD << '\n' << std::hex;
+      for(auto h : fabHashes) {
+        hashFile << h << '\n';
+      }
+    }
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
@@ -1172,7 +1777,9 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 		    const std::string &filePrefix,
                     VisMF::Header &hdr,
 		    VisMF::Header::Version /*whichVersion*/,
-		    NFilesIter &nfi, MPI_Comm comm)
+		    NFilesIter &nfi, MPI_Comm comm,
+                    const Vector<Long> &localFabBytes,
+                    const Vector<char> &writeFab)
 {
 //    BL_PROFILE("VisMF::FindOffsets");
 
@@ -1265,6 +1872,52 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
       int whichRDBytes(whichRD->numBytes());
       int nComps(mf.nComp());
 
+      // ---- compressed fabs have different sizes, gather them
+      Vector<Long> fabBytes;
+      if(compressedVersion(hdr.m_vers)) {
+        BL_ASSERT(localFabBytes.size() == mf.local_size());
+        fabBytes.resize(mf.size(), 0);
+        const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+#ifdef BL_USE_MPI
+        Vector<int> nmtags(nProcs,0);
+        Vector<int> offset(nProcs,0);
+        for(int i(0), N(mf.size()); i < N; ++i) {
+          ++nmtags[pmap[i]];
+        }
+        for(int i(1), N(offset.size()); i < N; ++i) {
+          offset[i] = offset[i-1] + nmtags[i-1];
+        }
+        Vector<Long> senddata(localFabBytes);
+        if(senddata.empty()) {
+          // Can't let senddata be empty as senddata.dataPtr() will fail.
+          senddata.resize(1);
+        }
+        Vector<Long> recvdata(mf.size());
+        BL_MPI_REQUIRE( MPI_Gatherv(senddata.dataPtr(),
+                                    nmtags[myProc],
+                                    ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                    recvdata.dataPtr(),
+                                    nmtags.dataPtr(),
+                                    offset.dataPtr(),
+                                    ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                    coordinatorProc,
+                                    comm) );
+        if(myProc == coordinatorProc) {
+          Vector<int> cnt(nProcs,0);
+          for(int j(0), N(mf.size()); j < N; ++j) {
+            const int i(pmap[j]);
+            fabBytes[j] = recvdata[offset[i]+cnt[i]];
+            ++cnt[i];
+          }
+        }
+#else
+        amrex::ignore_unused(pmap);
+        for(int li(0); li < localFabBytes.size(); ++li) {
+          fabBytes[mf.IndexArray()[li]] = localFabBytes[li];
+        }
+#endif
+      }
+
       if(myProc == coordinatorProc) {   // ---- calculate offsets
 	const BoxArray &mfBA = mf.boxArray();
 	const DistributionMapping &mfDM = mf.DistributionMap();
@@ -1319,10 +1972,17 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 	      whichFileName   = VisMF::BaseName(NFilesIter::FileName(whichFileNumber, filePrefix));
 
 	      for(int i(0); i < index.size(); ++i) {
+                 if( ! writeFab.empty() && ! writeFab[index[i]]) {
+                   continue;
+                 }
                  hdr.m_fod[index[i]].m_name = whichFileName;
                  hdr.m_fod[index[i]].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
-	                                           + fabHeaderBytes[index[i]];
+                 if(fabBytes.empty()) {
+                   currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
+	                                             + fabHeaderBytes[index[i]];
+                 } else {
+                   currentOffset[whichFileNumber] += fabBytes[index[i]];
+                 }
               }
             }
 	  }
@@ -1333,6 +1993,208 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::GatherBlockOffsets (const FabArray<FArrayBox> &mf,
+                           VisMF::Header &hdr,
+                           const Vector<Vector<Long> > &localBlockSizes,
+                           int coordinatorProc, MPI_Comm comm,
+                           const Vector<char> &writeFab)
+{
+    // ---- the block offsets of each fab relative to its start, and its end
+    BL_ASSERT(localBlockSizes.size() == mf.local_size());
+    Vector<Long> senddata;
+    for(int li(0); li < localBlockSizes.size(); ++li) {
+      senddata.push_back(0);
+      for(Long bytes : localBlockSizes[li]) {
+        senddata.push_back(senddata.back() + bytes);
+      }
+    }
+
+    const int nFabs(mf.size());
+    hdr.m_block_offsets.resize(nFabs);
+
+#ifdef BL_USE_MPI
+    const int myProc(ParallelDescriptor::MyProc(comm));
+    const int nProcs(ParallelDescriptor::NProcs(comm));
+    const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+    Vector<int> nmtags(nProcs,0);
+    Vector<int> offset(nProcs,0);
+    Vector<int> fabOffset(nFabs,0);
+    auto nOffsets = [&] (int i) {
+      return (writeFab.empty() || writeFab[i]) ? hdr.m_ncomp * numSlabs(mf.fabbox(i), hdr.m_slab) + 1
+                                               : 1;
+    };
+    for(int i(0); i < nFabs; ++i) {
+      nmtags[pmap[i]] += nOffsets(i);
+    }
+    for(int i(1); i < nProcs; ++i) {
+      offset[i] = offset[i-1] + nmtags[i-1];
+    }
+    BL_ASSERT(senddata.size() == nmtags[myProc]);
+    if(senddata.empty()) {
+      // Can't let senddata be empty as senddata.dataPtr() will fail.
+      senddata.resize(1);
+    }
+    Vector<Long> recvdata(myProc == coordinatorProc ? offset[nProcs-1] + nmtags[nProcs-1] : 1);
+
+    BL_MPI_REQUIRE( MPI_Gatherv(senddata.dataPtr(),
+                                nmtags[myProc],
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                recvdata.dataPtr(),
+                                nmtags.dataPtr(),
+                                offset.dataPtr(),
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                coordinatorProc,
+                                comm) );
+
+    if(myProc == coordinatorProc) {
+      Vector<int> cnt(nProcs,0);
+      for(int j(0); j < nFabs; ++j) {
+        const int i(pmap[j]);
+        const int n(nOffsets(j));
+        const Long *p = recvdata.dataPtr() + offset[i] + cnt[i];
+        hdr.m_block_offsets[j].assign(p, p + n);
+        cnt[i] += n;
+      }
+    }
+#else
+    amrex::ignore_unused(coordinatorProc, comm, writeFab);
+    int pos(0);
+    for(int li(0); li < localBlockSizes.size(); ++li) {
+      const int n(localBlockSizes[li].size() + 1);
+      hdr.m_block_offsets[mf.IndexArray()[li]].assign(senddata.begin() + pos,
+                                                      senddata.begin() + pos + n);
+      pos += n;
+    }
+#endif
+}
+
+
+Long
+VisMF::WriteAggregated (const FabArray<FArrayBox> &mf,
+                        const std::string &filePrefix,
+                        VisMF::Header &hdr,
+                        const RealDescriptor &whichRD,
+                        Vector<Vector<char> > &compressedFabs,
+                        int coordinatorProc,
+                        MPI_Comm comm,
+                        const Vector<char> &writeFab)
+{
+    BL_PROFILE("VisMF::WriteAggregated");
+
+    // ---- the local fabs in one buffer, as they would be written by NFilesIter
+    const int nLocal(mf.local_size());
+    Vector<Long> localOffsets(nLocal, 0);
+    Vector<char> localData;
+    if(compressedVersion(hdr.m_vers)) {
+      Long nbytes(0);
+      for(int li(0); li < nLocal; ++li) {
+        localOffsets[li] = nbytes;
+        nbytes += compressedFabs[li].size();
+      }
+      localData.resize(nbytes);
+      for(int li(0); li < nLocal; ++li) {
+        std::memcpy(localData.dataPtr() + localOffsets[li],
+                    compressedFabs[li].data(), compressedFabs[li].size());
+        Vector<char>().swap(compressedFabs[li]);
+      }
+    } else {
+      const FABio &fio = FArrayBox::getFABio();
+      const bool doConvert(whichRD != FPC::NativeRealDescriptor());
+      Vector<std::string> fabHeaders(nLocal);
+      Long nbytes(0);
+      for(int li(0); li < nLocal; ++li) {
+        const FArrayBox &fab = mf[mf.IndexArray()[li]];
+        localOffsets[li] = nbytes;
+        if( ! writeFab.empty() && ! writeFab[mf.IndexArray()[li]]) {
+          continue;
+        }
+        if(hdr.m_vers == VisMF::Header::Version_v1) {
+          std::stringstream hss;
+          fio.write_header(hss, fab, fab.nComp());
+          fabHeaders[li] = hss.str();
+        }
+        nbytes += fabHeaders[li].size() + fab.box().numPts() * mf.nComp() * whichRD.numBytes();
+      }
+      localData.resize(nbytes);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for(int li = 0; li < nLocal; ++li) {
+        if( ! writeFab.empty() && ! writeFab[mf.IndexArray()[li]]) {
+          continue;
+        }
+        const FArrayBox &fab = mf[mf.IndexArray()[li]];
+        const Long writeDataItems(fab.box().numPts() * mf.nComp());
+        char *afPtr = localData.dataPtr() + localOffsets[li];
+        std::memcpy(afPtr, fabHeaders[li].data(), fabHeaders[li].size());
+        afPtr += fabHeaders[li].size();
+        if(doConvert) {
+          RealDescriptor::convertFromNativeFormat(static_cast<void *> (afPtr),
+                                                  writeDataItems, fab.dataPtr(), whichRD);
+        } else {
+          std::memcpy(afPtr, fab.dataPtr(), writeDataItems * whichRD.numBytes());
+        }
+      }
+    }
+
+    NFilesAggregator agg(nAggregators, NFilesIter::FileName(0, filePrefix),
+                         stripeSize, aggregatorBufferSize, comm);
+    const Long myOffset(agg.Write(localData.dataPtr(), localData.size()));
+    const std::string fileName(VisMF::BaseName(agg.FileName()));
+
+    // ---- gather the fab offsets to the coordinator
+#ifdef BL_USE_MPI
+    const int myProc(ParallelDescriptor::MyProc(comm));
+    const int nProcs(ParallelDescriptor::NProcs(comm));
+    const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+    Vector<int> nmtags(nProcs,0);
+    Vector<int> offset(nProcs,0);
+    for(int i(0), N(mf.size()); i < N; ++i) {
+      ++nmtags[pmap[i]];
+    }
+    for(int i(1); i < nProcs; ++i) {
+      offset[i] = offset[i-1] + nmtags[i-1];
+    }
+    Vector<Long> senddata(nLocal);
+    for(int li(0); li < nLocal; ++li) {
+      senddata[li] = myOffset + localOffsets[li];
+    }
+    if(senddata.empty()) {
+      // Can't let senddata be empty as senddata.dataPtr() will fail.
+      senddata.resize(1);
+    }
+    Vector<Long> recvdata(mf.size());
+
+    BL_MPI_REQUIRE( MPI_Gatherv(senddata.dataPtr(),
+                                nmtags[myProc],
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                recvdata.dataPtr(),
+                                nmtags.dataPtr(),
+                                offset.dataPtr(),
+                                ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                coordinatorProc,
+                                comm) );
+
+    if(myProc == coordinatorProc) {
+      Vector<int> cnt(nProcs,0);
+      for(int j(0), N(mf.size()); j < N; ++j) {
+        const int i(pmap[j]);
+        hdr.m_fod[j] = VisMF::FabOnDisk(fileName, recvdata[offset[i]+cnt[i]]);
+        ++cnt[i];
+      }
+    }
+#else
+    amrex::ignore_unused(coordinatorProc);
+    for(int li(0); li < nLocal; ++li) {
+      hdr.m_fod[mf.IndexArray()[li]] = VisMF::FabOnDisk(fileName, myOffset + localOffsets[li]);
+    }
+#endif
+
+    return localData.size();
+}
+
+
 void
 VisMF::RemoveFiles(const std::string &mf_name, bool a_verbose)
 {
@@ -1401,7 +2263,8 @@ FArrayBox*
 VisMF::readFAB (int                  idx,
                 const std::string   &mf_name,
                 const VisMF::Header &hdr,
-		int                  whichComp)
+		int                  whichComp,
+                const Box           &region)
 {
 //    BL_PROFILE("VisMF::readFAB_idx");
     Box fab_box(hdr.m_ba[idx]);
@@ -1409,6 +2272,15 @@ VisMF::readFAB (int                  idx,
         fab_box.grow(hdr.m_ngrow);
     }
 
+    if(hdr.m_vers == Header::Indexed_v1 && hdr.m_slab > 0 && region.intersects(fab_box)) {
+      // ---- only the slabs that region intersects
+      const int dir(AMREX_SPACEDIM-1);
+      const int lo(fab_box.smallEnd(dir)), hi(fab_box.bigEnd(dir));
+      const Box rbox(region & fab_box);
+      fab_box.setSmall(dir, lo + (rbox.smallEnd(dir) - lo) / hdr.m_slab * hdr.m_slab);
+      fab_box.setBig(dir, std::min(hi, lo + ((rbox.bigEnd(dir) - lo) / hdr.m_slab + 1) * hdr.m_slab - 1));
+    }
+
     FArrayBox *fab = new FArrayBox(fab_box, whichComp == -1 ? hdr.m_ncomp : 1);
 
     std::string FullName(VisMF::DirName(mf_name));
@@ -1423,6 +2295,10 @@ VisMF::readFAB (int                  idx,
       } else {
         fab->readFrom(*infs, whichComp);
       }
+    } else if(hdr.m_vers == Header::Compressed_v1) {
+      decompressFab(*infs, hdr, *fab, whichComp);
+    } else if(hdr.m_vers == Header::Indexed_v1) {
+      readIndexedFab(*infs, hdr, idx, *fab, whichComp);
     } else {
       if(whichComp == -1) {    // ---- read all components
 	if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
@@ -1467,7 +2343,11 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(hdr.m_vers == Header::Compressed_v1) {
+      decompressFab(*infs, hdr, fab, -1);
+    } else if(hdr.m_vers == Header::Indexed_v1) {
+      readIndexedFab(*infs, hdr, idx, fab, -1);
+    } else if(NoFabHeader(hdr)) {
       if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fab.dataPtr(), fab.nBytes());
       } else {
@@ -1549,7 +2429,8 @@ VisMF::Read (FabArray<FArrayBox> &mf,
   int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
 
-  if(noFabHeader && useSynchronousReads) {
+  // ---- compressed fabs are read individually
+  if(noFabHeader && useSynchronousReads && ! compressedVersion(hdr.m_vers)) {
 
     // ---- This code is only for reading in file order
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
@@ -2096,7 +2977,8 @@ VisMF::clear ()
 bool VisMF::NoFabHeader(const VisMF::Header &hdr) {
   if(hdr.m_vers == VisMF::Header::NoFabHeader_v1       ||
     hdr.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+    compressedVersion(hdr.m_vers))
   {
     return true;
   }
@@ -2180,7 +3062,7 @@ void VisMF::CloseAllStreams() {
 void
 VisMF::AsyncWrite (const FabArray<FArrayBox>& mf, const std::string& mf_name, bool valid_cells_only)
 {
-    if (AsyncOut::UseAsyncOut()) {
+    if (AsyncOut::Running()) {
         AsyncWriteDoit(mf, mf_name, false, valid_cells_only);
     } else {
         if (valid_cells_only and mf.nGrowVect() != 0) {
@@ -2196,7 +3078,7 @@ VisMF::AsyncWrite (const FabArray<FArrayBox>& mf, const std::string& mf_name, bo
 void
 VisMF::AsyncWrite (FabArray<FArrayBox>&& mf, const std::string& mf_name, bool valid_cells_only)
 {
-    if (AsyncOut::UseAsyncOut()) {
+    if (AsyncOut::Running()) {
         AsyncWriteDoit(mf, mf_name, true, valid_cells_only);
     } else {
         if (valid_cells_only and mf.nGrowVect() != 0) {
@@ -0,0 +1,394 @@
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+
+#include <AMReX.H>
+#include <AMReX_VisMFCodec.H>
+
+namespace amrex {
+
+namespace VisMFCompression {
+
+void
+shuffle (const char* in, Long n, int elem_size, char* out)
+{
+    for (int b = 0; b < elem_size; ++b) {
+        char* AMREX_RESTRICT o = out + b*n;
+        const char* AMREX_RESTRICT p = in + b;
+        for (Long i = 0; i < n; ++i) {
+            o[i] = p[i*elem_size];
+        }
+    }
+}
+
+void
+unshuffle (const char* in, Long n, int elem_size, char* out)
+{
+    for (int b = 0; b < elem_size; ++b) {
+        const char* AMREX_RESTRICT p = in + b*n;
+        char* AMREX_RESTRICT o = out + b;
+        for (Long i = 0; i < n; ++i) {
+            o[i*elem_size] = p[i];
+        }
+    }
+}
+
+//
+// The LZ77 stream is a sequence of
+//
+//   token, [literal length bytes], literals, offset (2 bytes), [match length bytes]
+//
+// The high and low 4 bits of the token are the literal length and the
+// match length minus MinMatch.  A value of 15 means that more bytes follow,
+// each added to the length, until one that is not 255.  The last sequence
+// has literals only.
+//
+namespace {
+    constexpr int  MinMatch = 4;
+    constexpr int  HashLog  = 16;
+    constexpr Long MaxOffset = 65535;
+    // No match starts in the last MatchLimit bytes, and the last LastLiterals
+    // bytes are always literals.
+    constexpr Long MatchLimit = 12;
+    constexpr Long LastLiterals = 5;
+
+    inline std::uint32_t read32 (const unsigned char* p) noexcept
+    {
+        std::uint32_t r;
+        std::memcpy(&r, p, 4);
+        return r;
+    }
+
+    inline std::uint32_t hash32 (std::uint32_t v) noexcept
+    {
+        return (v * 2654435761U) >> (32-HashLog);
+    }
+
+    void putLength (Long len, Vector<char>& out)
+    {
+        for (len -= 15; len >= 255; len -= 255) {
+            out.push_back(static_cast<char>(255));
+        }
+        out.push_back(static_cast<char>(len));
+    }
+
+    void putSequence (const unsigned char* lit, Long nlit, Long offset, Long mlen,
+                      Vector<char>& out)
+    {
+        const int tlit = std::min<Long>(nlit, 15);
+        const int tmat = (mlen > 0) ? std::min<Long>(mlen-MinMatch, 15) : 0;
+        out.push_back(static_cast<char>((tlit << 4) | tmat));
+        if (tlit == 15) putLength(nlit, out);
+        out.insert(out.end(), lit, lit+nlit);
+        if (mlen > 0) {
+            out.push_back(static_cast<char>(offset & 0xff));
+            out.push_back(static_cast<char>(offset >> 8));
+            if (tmat == 15) putLength(mlen-MinMatch, out);
+        }
+    }
+
+    void corrupt ()
+    {
+        amrex::Abort("VisMFCompression::lzDecompress: corrupt data");
+    }
+}
+
+void
+lzCompress (const char* a_in, Long nin, Vector<char>& out)
+{
+    const auto in = reinterpret_cast<const unsigned char*>(a_in);
+    Long anchor = 0;
+
+    if (nin > MatchLimit)
+    {
+        std::vector<Long> table(Long(1) << HashLog, -1);
+        const Long limit = nin - MatchLimit;
+        const Long match_end = nin - LastLiterals;
+        Long ip = 0;
+        while (ip < limit)
+        {
+            const std::uint32_t v = read32(in+ip);
+            const std::uint32_t h = hash32(v);
+            const Long ref = table[h];
+            table[h] = ip;
+            if (ref >= 0 && ip-ref <= MaxOffset && read32(in+ref) == v)
+            {
+                Long mlen = MinMatch;
+                while (ip+mlen < match_end && in[ref+mlen] == in[ip+mlen]) {
+                    ++mlen;
+                }
+                putSequence(in+anchor, ip-anchor, ip-ref, mlen, out);
+                ip += mlen;
+                anchor = ip;
+                if (ip < limit) {
+                    table[hash32(read32(in+ip-2))] = ip-2;
+                }
+            }
+            else
+            {
+                // Skip faster through data that do not compress.
+                ip += 1 + ((ip-anchor) >> 6);
+            }
+        }
+    }
+
+    putSequence(in+anchor, nin-anchor, 0, 0, out);
+}
+
+void
+lzDecompress (const char* a_in, Long nin, char* a_out, Long nout)
+{
+    const auto in = reinterpret_cast<const unsigned char*>(a_in);
+    auto out = reinterpret_cast<unsigned char*>(a_out);
+
+    Long ip = 0, op = 0;
+    while (ip < nin)
+    {
+        const int token = in[ip++];
+        Long nlit = token >> 4;
+        if (nlit == 15) {
+            int b;
+            do {
+                if (ip >= nin) corrupt();
+                b = in[ip++];
+                nlit += b;
+            } while (b == 255);
+        }
+        if (ip+nlit > nin || op+nlit > nout) corrupt();
+        std::memcpy(out+op, in+ip, nlit);
+        ip += nlit;
+        op += nlit;
+
+        if (ip == nin) break;
+
+        if (ip+2 > nin) corrupt();
+        const Long offset = in[ip] | (Long(in[ip+1]) << 8);
+        ip += 2;
+        Long mlen = token & 15;
+        if (mlen == 15) {
+            int b;
+            do {
+                if (ip >= nin) corrupt();
+                b = in[ip++];
+                mlen += b;
+            } while (b == 255);
+        }
+        mlen += MinMatch;
+        if (offset == 0 || offset > op || op+mlen > nout) corrupt();
+        const unsigned char* src = out + op - offset;
+        if (offset >= mlen) {
+            std::memcpy(out+op, src, mlen);
+        } else {
+            for (Long i = 0; i < mlen; ++i) {
+                out[op+i] = src[i];
+            }
+        }
+        op += mlen;
+    }
+
+    if (op != nout) corrupt();
+}
+
+namespace {
+
+class ShuffleLZCodec
+    : public VisMFCodec
+{
+public:
+
+    virtual std::string name () const override { return "shuffle_lz"; }
+
+    virtual void compress (const char* in, Long nelems, int elem_size, bool /*native_fp*/,
+                           Vector<char>& out) const override
+    {
+        Vector<char> tmp(nelems*elem_size);
+        shuffle(in, nelems, elem_size, tmp.data());
+        lzCompress(tmp.data(), tmp.size(), out);
+    }
+
+    virtual void decompress (const char* in, Long nin, char* out,
+                             Long nelems, int elem_size) const override
+    {
+        Vector<char> tmp(nelems*elem_size);
+        lzDecompress(in, nin, tmp.data(), tmp.size());
+        unshuffle(tmp.data(), nelems, elem_size, out);
+    }
+};
+
+class QuantizeCodec
+    : public VisMFCodec
+{
+public:
+
+    QuantizeCodec (double abs_error, double rel_error)
+        : m_abs_error(abs_error), m_rel_error(rel_error) {}
+
+    virtual std::string name () const override { return "quantize"; }
+
+    virtual void compress (const char* in, Long nelems, int elem_size, bool native_fp,
+                           Vector<char>& out) const override
+    {
+        if (native_fp && elem_size == sizeof(double)) {
+            quantize(reinterpret_cast<const double*>(in), nelems, out);
+        } else if (native_fp && elem_size == sizeof(float)) {
+            quantize(reinterpret_cast<const float*>(in), nelems, out);
+        } else {
+            out.push_back(Lossless);
+            m_lossless.compress(in, nelems, elem_size, native_fp, out);
+        }
+    }
+
+    virtual void decompress (const char* in, Long nin, char* out,
+                             Long nelems, int elem_size) const override
+    {
+        if (nin < 1) corrupt();
+        if (in[0] == Lossless) {
+            m_lossless.decompress(in+1, nin-1, out, nelems, elem_size);
+        } else if (elem_size == sizeof(double)) {
+            dequantize(in, nin, reinterpret_cast<double*>(out), nelems);
+        } else if (elem_size == sizeof(float)) {
+            dequantize(in, nin, reinterpret_cast<float*>(out), nelems);
+        } else {
+            corrupt();
+        }
+    }
+
+private:
+
+    enum : char { Lossless = 0, Quantized = 1 };
+
+    template <typename T>
+    void quantize (const T* v, Long n, Vector<char>& out) const
+    {
+        double vmin = std::numeric_limits<double>::max();
+        double vmax = std::numeric_limits<double>::lowest();
+        bool finite = true;
+        for (Long i = 0; i < n; ++i) {
+            finite = finite && std::isfinite(v[i]);
+            vmin = std::min(vmin, double(v[i]));
+            vmax = std::max(vmax, double(v[i]));
+        }
+
+        const double range = vmax - vmin;
+        const double eb = (m_abs_error > 0.) ? m_abs_error : m_rel_error*range;
+        const double maxabs = std::max(std::abs(vmin), std::abs(vmax));
+        //
+        // The rounding of the reconstruction must stay well below the error
+        // bound, and the number of steps must fit in an integer.
+        //
+        const double eps = std::numeric_limits<T>::epsilon();
+        if (n == 0 || !finite || !(eb > 16.*eps*maxabs) || range/eb > 1.e12) {
+            out.push_back(Lossless);
+            m_lossless.compress(reinterpret_cast<const char*>(v), n, sizeof(T), true, out);
+            return;
+        }
+        const double step = (range > 0.) ? 1.99*eb : 1.0;
+
+        std::vector<std::uint64_t> d(n);
+        std::int64_t qprev = 0;
+        std::uint64_t dmax = 0;
+        for (Long i = 0; i < n; ++i) {
+            const std::int64_t q = std::llround((v[i]-vmin)/step);
+            const std::int64_t dq = q - qprev;
+            qprev = q;
+            d[i] = (static_cast<std::uint64_t>(dq) << 1) ^ static_cast<std::uint64_t>(dq >> 63);
+            dmax = std::max(dmax, d[i]);
+        }
+        int width = 1;
+        while (width < 8 && (dmax >> (8*width)) != 0) ++width;
+
+        Vector<char> packed(n*width);
+        for (Long i = 0; i < n; ++i) {
+            for (int b = 0; b < width; ++b) {
+                packed[i*width+b] = static_cast<char>((d[i] >> (8*b)) & 0xff);
+            }
+        }
+        Vector<char> shuffled(packed.size());
+        shuffle(packed.data(), n, width, shuffled.data());
+
+        out.push_back(Quantized);
+        const char* p = reinterpret_cast<const char*>(&vmin);
+        out.insert(out.end(), p, p+sizeof(double));
+        p = reinterpret_cast<const char*>(&step);
+        out.insert(out.end(), p, p+sizeof(double));
+        out.push_back(static_cast<char>(width));
+        lzCompress(shuffled.data(), shuffled.size(), out);
+    }
+
+    template <typename T>
+    void dequantize (const char* in, Long nin, T* v, Long n) const
+    {
+        constexpr Long hdr_size = 1 + 2*sizeof(double) + 1;
+        if (nin < hdr_size) corrupt();
+        double vmin, step;
+        std::memcpy(&vmin, in+1, sizeof(double));
+        std::memcpy(&step, in+1+sizeof(double), sizeof(double));
+        const int width = in[1+2*sizeof(double)];
+        if (width < 1 || width > 8) corrupt();
+
+        Vector<char> shuffled(n*width), packed(n*width);
+        lzDecompress(in+hdr_size, nin-hdr_size, shuffled.data(), shuffled.size());
+        unshuffle(shuffled.data(), n, width, packed.data());
+
+        std::int64_t q = 0;
+        for (Long i = 0; i < n; ++i) {
+            std::uint64_t d = 0;
+            for (int b = 0; b < width; ++b) {
+                d |= std::uint64_t(static_cast<unsigned char>(packed[i*width+b])) << (8*b);
+            }
+            q += static_cast<std::int64_t>(d >> 1) ^ -static_cast<std::int64_t>(d & 1);
+            v[i] = static_cast<T>(vmin + q*step);
+        }
+    }
+
+    double m_abs_error;
+    double m_rel_error;
+    ShuffleLZCodec m_lossless;
+};
+
+std::mutex codec_mutex;
+
+std::map<std::string,std::unique_ptr<VisMFCodec> >&
+codecs ()
+{
+    static std::map<std::string,std::unique_ptr<VisMFCodec> > m;
+    if (m.empty()) {
+        m["shuffle_lz"].reset(new ShuffleLZCodec());
+        m["quantize"] = makeQuantizeCodec(0., 1.e-5);
+    }
+    return m;
+}
+
+}
+
+std::unique_ptr<VisMFCodec>
+makeQuantizeCodec (double abs_error, double rel_error)
+{
+    return std::unique_ptr<VisMFCodec>(new QuantizeCodec(abs_error, rel_error));
+}
+
+}
+
+void
+VisMFCodec::Register (std::unique_ptr<VisMFCodec> codec)
+{
+    std::lock_guard<std::mutex> lock(VisMFCompression::codec_mutex);
+    const std::string nm = codec->name();
+    VisMFCompression::codecs()[nm] = std::move(codec);
+}
+
+const VisMFCodec*
+VisMFCodec::Find (const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(VisMFCompression::codec_mutex);
+    auto& m = VisMFCompression::codecs();
+    auto it = m.find(name);
+    return (it == m.end()) ? nullptr : it->second.get();
+}
+
+}
@@ -45,6 +45,26 @@ HypreABecLap3::solve (MultiFab& soln, const MultiFab& rhs, Real rel_tol, Real ab
     else
     {
         m_factory = &(rhs.Factory());
+#ifdef AMREX_USE_EB
+        // The EB stencil leaves out zero entries, so new coefficients
+        // may change the sparsity pattern of cut cell rows.
+        auto ebfactory = dynamic_cast<EBFArrayBoxFactory const*>(m_factory);
+        const bool same_pattern = !ebfactory || ebfactory->isAllRegular();
+#else
+        const bool same_pattern = true;
+#endif
+        if (m_coeffs_changed && !same_pattern)
+        {
+            prepareSolver();
+        }
+        else if (m_coeffs_changed)
+        {
+            // Same grids and boundary: keep the IJ structure and only
+            // reload the matrix values.
+            HYPRE_IJMatrixInitialize(A);
+            loadMatrix();
+            hypre_ij->resetSetup();
+        }
     }
 
     HYPRE_IJVectorInitialize(b);
@@ -159,13 +179,6 @@ HypreABecLap3::prepareSolver ()
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_overset_mask == nullptr || ebfactory == nullptr,
                                      "Cannot have both EB and overset");
     const FabArray<EBCellFlagFab>* flags = (ebfactory) ? &(ebfactory->getMultiEBCellFlagFab()) : nullptr;
-    const MultiFab* vfrac = (ebfactory) ? &(ebfactory->getVolFrac()) : nullptr;
-    auto area = (ebfactory) ? ebfactory->getAreaFrac()
-        : Array<const MultiCutFab*,AMREX_SPACEDIM>{AMREX_D_DECL(nullptr,nullptr,nullptr)};
-    auto fcent = (ebfactory) ? ebfactory->getFaceCent()
-        : Array<const MultiCutFab*,AMREX_SPACEDIM>{AMREX_D_DECL(nullptr,nullptr,nullptr)};
-    auto barea = (ebfactory) ? &(ebfactory->getBndryArea()) : nullptr;
-    auto bcent = (ebfactory) ? &(ebfactory->getBndryCent()) : nullptr;
 #endif
 
     HYPRE_Int ncells_proc = 0;
@@ -216,14 +229,12 @@ HypreABecLap3::prepareSolver ()
         proc_begin += ncells_allprocs[i];
     }
 
-#ifdef AMREX_DEBUG
-    HYPRE_Int ncells_total = 0;
+    ncells_total = 0;
     for (auto n : ncells_allprocs) {
         ncells_total += n;
     }
-#endif
 
-    LayoutData<HYPRE_Int> offset(ba,dm);
+    offset.define(ba,dm);
     HYPRE_Int proc_end = proc_begin;
     for (MFIter mfi(ncells_grid); mfi.isValid(); ++mfi)
     {
@@ -255,6 +266,26 @@ HypreABecLap3::prepareSolver ()
     b = hypre_ij->b();
     x = hypre_ij->x();
 
+    loadMatrix();
+}
+
+void
+HypreABecLap3::loadMatrix ()
+{
+    BL_PROFILE("HypreABecLap3::loadMatrix()");
+
+#ifdef AMREX_USE_EB
+    auto ebfactory = dynamic_cast<EBFArrayBoxFactory const*>(m_factory);
+    const FabArray<EBCellFlagFab>* flags = (ebfactory) ? &(ebfactory->getMultiEBCellFlagFab()) : nullptr;
+    const MultiFab* vfrac = (ebfactory) ? &(ebfactory->getVolFrac()) : nullptr;
+    auto area = (ebfactory) ? ebfactory->getAreaFrac()
+        : Array<const MultiCutFab*,AMREX_SPACEDIM>{AMREX_D_DECL(nullptr,nullptr,nullptr)};
+    auto fcent = (ebfactory) ? ebfactory->getFaceCent()
+        : Array<const MultiCutFab*,AMREX_SPACEDIM>{AMREX_D_DECL(nullptr,nullptr,nullptr)};
+    auto barea = (ebfactory) ? &(ebfactory->getBndryArea()) : nullptr;
+    auto bcent = (ebfactory) ? &(ebfactory->getBndryCent()) : nullptr;
+#endif
+
     const Real* dx = geom.CellSize();
     const int bho = (m_maxorder > 2) ? 1 : 0;
     FArrayBox foo(Box::TheUnitBox());
@@ -376,6 +407,8 @@ HypreABecLap3::prepareSolver ()
         }
     }
     HYPRE_IJMatrixAssemble(A);
+
+    m_coeffs_changed = false;
 }
 
 void
@@ -3,6 +3,7 @@
 #include <AMReX_MultiFabUtil.H>
 
 #include <AMReX_MLABecLap_K.H>
+#include <AMReX_MLLinOp_K.H>
 
 namespace amrex {
 
@@ -10,9 +11,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<BoxArray>& a_grids,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  const int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_info, a_factory, a_ncomp);
 }
 
 MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
@@ -20,9 +22,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const Vector<iMultiFab const*>& a_overset_mask,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  const int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_overset_mask, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_overset_mask, a_info, a_factory, a_ncomp);
 }
 
 void
@@ -30,13 +33,17 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<BoxArray>& a_grids,
                          const Vector<DistributionMapping>& a_dmap,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         const int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define()");
 
+    m_ncomp = a_ncomp;
+
     MLCellABecLap::define(a_geom, a_grids, a_dmap, a_info, a_factory);
 
-    const int ncomp = getNComp();
+    // A batch of right-hand sides shares one set of b coefficients.
+    const int ncomp = isBatched() ? 1 : getNComp();
 
     m_a_coeffs.resize(m_num_amr_levels);
     m_b_coeffs.resize(m_num_amr_levels);
@@ -69,7 +76,8 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<DistributionMapping>& a_dmap,
                          const Vector<iMultiFab const*>& a_overset_mask,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         const int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define(overset)");
 
@@ -129,7 +137,7 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
     LPInfo linfo = a_info;
     linfo.max_coarsening_level = std::min(a_info.max_coarsening_level,
                                           max_overset_mask_coarsening_level);
-    define(a_geom, a_grids, a_dmap, linfo, a_factory);
+    define(a_geom, a_grids, a_dmap, linfo, a_factory, a_ncomp);
 
     amrlev = 0;
     for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev) {
@@ -164,6 +172,7 @@ MLABecLaplacian::setScalars (Real a, Real b) noexcept
             m_a_coeffs[amrlev][0].setVal(0.0);
         }
     }
+    m_needs_update = true;
 }
 
 void
@@ -184,7 +193,7 @@ void
 MLABecLaplacian::setBCoeffs (int amrlev,
                              const Array<MultiFab const*,AMREX_SPACEDIM>& beta)
 {
-    const int ncomp = getNComp();
+    const int ncomp = m_b_coeffs[amrlev][0][0].nComp();
     AMREX_ALWAYS_ASSERT(beta[0]->nComp() == 1 or beta[0]->nComp() == ncomp);
     if (beta[0]->nComp() == ncomp)
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
@@ -213,7 +222,7 @@ MLABecLaplacian::setBCoeffs (int amrlev, Real beta)
 void
 MLABecLaplacian::setBCoeffs (int amrlev, Vector<Real> const& beta)
 {
-    const int ncomp = getNComp();
+    const int ncomp = m_b_coeffs[amrlev][0][0].nComp();
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         for (int icomp = 0; icomp < ncomp; ++icomp) {
             m_b_coeffs[amrlev][0][idim].setVal(beta[icomp]);
@@ -272,7 +281,7 @@ MLABecLaplacian::averageDownCoeffsSameAmrLevel (int amrlev, Vector<MultiFab>& a,
         if (m_overset_mask[amrlev][mglev]) {
             const Real fac = static_cast<Real>(1 << mglev); // 2**mglev
             const Real osfac = 2.0*fac/(fac+1.0);
-            const int ncomp = getNComp();
+            const int ncomp = b[mglev][0].nComp();
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -405,9 +414,9 @@ MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
         const auto& xfab = in.array(mfi);
         const auto& yfab = out.array(mfi);
         const auto& afab = acoef.array(mfi);
-        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
-                     const auto& byfab = bycoef.array(mfi);,
-                     const auto& bzfab = bzcoef.array(mfi););
+        AMREX_D_TERM(const auto& bxfab = mllinop_bcast_comp(bxcoef.const_array(mfi), ncomp);,
+                     const auto& byfab = mllinop_bcast_comp(bycoef.const_array(mfi), ncomp);,
+                     const auto& bzfab = mllinop_bcast_comp(bzcoef.const_array(mfi), ncomp););
         if (m_overset_mask[amrlev][mglev]) {
             const auto& osm = m_overset_mask[amrlev][mglev]->array(mfi);
             AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( bx, tbx,
@@ -450,9 +459,9 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
         const Box& bx = mfi.tilebox();
         const auto& fab = mf.array(mfi);
         const auto& afab = acoef.array(mfi);
-        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
-                     const auto& byfab = bycoef.array(mfi);,
-                     const auto& bzfab = bzcoef.array(mfi););
+        AMREX_D_TERM(const auto& bxfab = mllinop_bcast_comp(bxcoef.const_array(mfi), ncomp);,
+                     const auto& byfab = mllinop_bcast_comp(bycoef.const_array(mfi), ncomp);,
+                     const auto& bzfab = mllinop_bcast_comp(bzcoef.const_array(mfi), ncomp););
 
         AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( bx, tbx,
         {
@@ -535,9 +544,9 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
         const auto& rhsfab  = rhs.array(mfi);
         const auto& afab    = acoef.array(mfi);
 
-        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
-                     const auto& byfab = bycoef.array(mfi);,
-                     const auto& bzfab = bzcoef.array(mfi););
+        AMREX_D_TERM(const auto& bxfab = mllinop_bcast_comp(bxcoef.const_array(mfi), nc);,
+                     const auto& byfab = mllinop_bcast_comp(bycoef.const_array(mfi), nc);,
+                     const auto& bzfab = mllinop_bcast_comp(bzcoef.const_array(mfi), nc););
 
         const auto& f0fab = f0.array(mfi);
         const auto& f1fab = f1.array(mfi);
@@ -651,6 +660,191 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     }
 }
 
+bool
+MLABecLaplacian::supportsMixedPrecision () const
+{
+#ifdef AMREX_USE_DPCPP
+    return false;
+#else
+    for (auto const& ratio : mg_coarsen_ratio_vec) {
+        if (ratio != mg_coarsen_ratio) return false;
+    }
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev) {
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev) {
+            if (m_overset_mask[amrlev][mglev]) return false;
+        }
+    }
+    return true;
+#endif
+}
+
+void
+MLABecLaplacian::prepareForMixedPrecision ()
+{
+    BL_PROFILE("MLABecLaplacian::prepareForMixedPrecision()");
+
+    m_a_coeffs_single.resize(m_num_amr_levels);
+    m_b_coeffs_single.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_a_coeffs_single[amrlev].resize(m_num_mg_levels[amrlev]);
+        m_b_coeffs_single[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 1; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+            FMultiFab& facoef = m_a_coeffs_single[amrlev][mglev];
+            if (!facoef.ok()) {
+                facoef.define(acoef.boxArray(), acoef.DistributionMap(), acoef.nComp(), acoef.nGrow());
+            }
+            convertCopy(facoef, acoef, acoef.nComp(), acoef.nGrow());
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                const MultiFab& bcoef = m_b_coeffs[amrlev][mglev][idim];
+                FMultiFab& fbcoef = m_b_coeffs_single[amrlev][mglev][idim];
+                if (!fbcoef.ok()) {
+                    fbcoef.define(bcoef.boxArray(), bcoef.DistributionMap(), bcoef.nComp(), bcoef.nGrow());
+                }
+                convertCopy(fbcoef, bcoef, bcoef.nComp(), bcoef.nGrow());
+            }
+        }
+    }
+}
+
+void
+MLABecLaplacian::FapplySingle (int amrlev, int mglev, FMultiFab& out, const FMultiFab& in) const
+{
+    BL_PROFILE("MLABecLaplacian::FapplySingle()");
+
+    const FMultiFab& acoef = m_a_coeffs_single[amrlev][mglev];
+    AMREX_D_TERM(const FMultiFab& bxcoef = m_b_coeffs_single[amrlev][mglev][0];,
+                 const FMultiFab& bycoef = m_b_coeffs_single[amrlev][mglev][1];,
+                 const FMultiFab& bzcoef = m_b_coeffs_single[amrlev][mglev][2];);
+
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+
+    const Real ascalar = m_a_scalar;
+    const Real bscalar = m_b_scalar;
+
+    const int ncomp = getNComp();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(out, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& xfab = in.array(mfi);
+        const auto& yfab = out.array(mfi);
+        const auto& afab = acoef.array(mfi);
+        AMREX_D_TERM(const auto& bxfab = mllinop_bcast_comp(bxcoef.const_array(mfi), ncomp);,
+                     const auto& byfab = mllinop_bcast_comp(bycoef.const_array(mfi), ncomp);,
+                     const auto& bzfab = mllinop_bcast_comp(bzcoef.const_array(mfi), ncomp););
+        AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( bx, tbx,
+        {
+            mlabeclap_adotx(tbx, yfab, xfab, afab, AMREX_D_DECL(bxfab,byfab,bzfab),
+                            dxinv, ascalar, bscalar, ncomp);
+        });
+    }
+}
+
+void
+MLABecLaplacian::FsmoothSingle (int amrlev, int mglev, FMultiFab& sol, const FMultiFab& rhs,
+                                int redblack) const
+{
+    BL_PROFILE("MLABecLaplacian::FsmoothSingle()");
+
+    const FMultiFab& acoef = m_a_coeffs_single[amrlev][mglev];
+    AMREX_D_TERM(const FMultiFab& bxcoef = m_b_coeffs_single[amrlev][mglev][0];,
+                 const FMultiFab& bycoef = m_b_coeffs_single[amrlev][mglev][1];,
+                 const FMultiFab& bzcoef = m_b_coeffs_single[amrlev][mglev][2];);
+    const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
+    const auto& maskvals  = m_maskvals [amrlev][mglev];
+
+    OrientationIter oitr;
+
+    const FabSet& f0 = undrrelxr[oitr()]; ++oitr;
+    const FabSet& f1 = undrrelxr[oitr()]; ++oitr;
+#if (AMREX_SPACEDIM > 1)
+    const FabSet& f2 = undrrelxr[oitr()]; ++oitr;
+    const FabSet& f3 = undrrelxr[oitr()]; ++oitr;
+#if (AMREX_SPACEDIM > 2)
+    const FabSet& f4 = undrrelxr[oitr()]; ++oitr;
+    const FabSet& f5 = undrrelxr[oitr()]; ++oitr;
+#endif
+#endif
+
+    const MultiMask& mm0 = maskvals[0];
+    const MultiMask& mm1 = maskvals[1];
+#if (AMREX_SPACEDIM > 1)
+    const MultiMask& mm2 = maskvals[2];
+    const MultiMask& mm3 = maskvals[3];
+#if (AMREX_SPACEDIM > 2)
+    const MultiMask& mm4 = maskvals[4];
+    const MultiMask& mm5 = maskvals[5];
+#endif
+#endif
+
+    const int nc = getNComp();
+    const Real* h = m_geom[amrlev][mglev].CellSize();
+    AMREX_D_TERM(const Real dhx = m_b_scalar/(h[0]*h[0]);,
+                 const Real dhy = m_b_scalar/(h[1]*h[1]);,
+                 const Real dhz = m_b_scalar/(h[2]*h[2]));
+    const Real alpha = m_a_scalar;
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(sol,mfi_info); mfi.isValid(); ++mfi)
+    {
+        const auto& m0 = mm0.array(mfi);
+        const auto& m1 = mm1.array(mfi);
+#if (AMREX_SPACEDIM > 1)
+        const auto& m2 = mm2.array(mfi);
+        const auto& m3 = mm3.array(mfi);
+#if (AMREX_SPACEDIM > 2)
+        const auto& m4 = mm4.array(mfi);
+        const auto& m5 = mm5.array(mfi);
+#endif
+#endif
+
+        const Box& tbx = mfi.tilebox();
+        const Box& vbx = mfi.validbox();
+        const auto& solnfab = sol.array(mfi);
+        const auto& rhsfab  = rhs.array(mfi);
+        const auto& afab    = acoef.array(mfi);
+
+        AMREX_D_TERM(const auto& bxfab = mllinop_bcast_comp(bxcoef.const_array(mfi), nc);,
+                     const auto& byfab = mllinop_bcast_comp(bycoef.const_array(mfi), nc);,
+                     const auto& bzfab = mllinop_bcast_comp(bzcoef.const_array(mfi), nc););
+
+        const auto& f0fab = f0.array(mfi);
+        const auto& f1fab = f1.array(mfi);
+#if (AMREX_SPACEDIM > 1)
+        const auto& f2fab = f2.array(mfi);
+        const auto& f3fab = f3.array(mfi);
+#if (AMREX_SPACEDIM > 2)
+        const auto& f4fab = f4.array(mfi);
+        const auto& f5fab = f5.array(mfi);
+#endif
+#endif
+
+        AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( tbx, thread_box,
+        {
+            abec_gsrb(thread_box, solnfab, rhsfab, alpha, afab,
+                      AMREX_D_DECL(dhx, dhy, dhz),
+                      AMREX_D_DECL(bxfab, byfab, bzfab),
+                      AMREX_D_DECL(m0,m2,m4),
+                      AMREX_D_DECL(m1,m3,m5),
+                      AMREX_D_DECL(f0fab,f2fab,f4fab),
+                      AMREX_D_DECL(f1fab,f3fab,f5fab),
+                      vbx, redblack, nc);
+        });
+    }
+}
+
 void
 MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
                         const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -675,9 +869,9 @@ MLABecLaplacian::FFlux (Box const& box, Real const* dxinv, Real bscalar,
                         Array<FArrayBox*,AMREX_SPACEDIM> const& flux,
                         FArrayBox const& sol, int face_only, int ncomp)
 {
-    AMREX_D_TERM(const auto bx = bcoef[0]->array();,
-                 const auto by = bcoef[1]->array();,
-                 const auto bz = bcoef[2]->array(););
+    AMREX_D_TERM(const auto bx = mllinop_bcast_comp(bcoef[0]->const_array(), ncomp);,
+                 const auto by = mllinop_bcast_comp(bcoef[1]->const_array(), ncomp);,
+                 const auto bz = mllinop_bcast_comp(bcoef[2]->const_array(), ncomp););
     AMREX_D_TERM(const auto& fxarr = flux[0]->array();,
                  const auto& fyarr = flux[1]->array();,
                  const auto& fzarr = flux[2]->array(););
@@ -0,0 +1,1160 @@
+#include <AMReX_MLAMGSolver.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_LO_BCTYPES.H>
+#include <AMReX_Print.H>
+
+#ifdef AMREX_USE_EB
+#include <AMReX_EBFabFactory.H>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace amrex {
+
+namespace {
+
+// y = A*x
+template <class M>
+void
+spmv (const M& A, const Vector<Real>& x, Vector<Real>& y)
+{
+    const int* AMREX_RESTRICT ptr = A.ptr.data();
+    const int* AMREX_RESTRICT col = A.col.data();
+    const Real* AMREX_RESTRICT val = A.val.data();
+    const Real* AMREX_RESTRICT xp = x.data();
+    Real* AMREX_RESTRICT yp = y.data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < A.nrows; ++i) {
+        Real s = 0.0;
+        for (int jj = ptr[i]; jj < ptr[i+1]; ++jj) {
+            s += val[jj] * xp[col[jj]];
+        }
+        yp[i] = s;
+    }
+}
+
+// r = b - A*x
+template <class M>
+void
+residual (const M& A, const Vector<Real>& x, const Vector<Real>& b, Vector<Real>& r)
+{
+    const int* AMREX_RESTRICT ptr = A.ptr.data();
+    const int* AMREX_RESTRICT col = A.col.data();
+    const Real* AMREX_RESTRICT val = A.val.data();
+    const Real* AMREX_RESTRICT xp = x.data();
+    const Real* AMREX_RESTRICT bp = b.data();
+    Real* AMREX_RESTRICT rp = r.data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < A.nrows; ++i) {
+        Real s = bp[i];
+        for (int jj = ptr[i]; jj < ptr[i+1]; ++jj) {
+            s -= val[jj] * xp[col[jj]];
+        }
+        rp[i] = s;
+    }
+}
+
+Real
+dotxy (const Vector<Real>& x, const Vector<Real>& y)
+{
+    const int n = x.size();
+    const Real* AMREX_RESTRICT xp = x.data();
+    const Real* AMREX_RESTRICT yp = y.data();
+    Real s = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:s)
+#endif
+    for (int i = 0; i < n; ++i) {
+        s += xp[i]*yp[i];
+    }
+    return s;
+}
+
+Real
+norm_inf (const Vector<Real>& x)
+{
+    const int n = x.size();
+    const Real* AMREX_RESTRICT xp = x.data();
+    Real s = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(max:s)
+#endif
+    for (int i = 0; i < n; ++i) {
+        s = std::max(s, std::abs(xp[i]));
+    }
+    return s;
+}
+
+// y += a*x
+void
+axpy (Vector<Real>& y, Real a, const Vector<Real>& x)
+{
+    const int n = x.size();
+    const Real* AMREX_RESTRICT xp = x.data();
+    Real* AMREX_RESTRICT yp = y.data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i = 0; i < n; ++i) {
+        yp[i] += a*xp[i];
+    }
+}
+
+// Columns of the transpose come out sorted.
+template <class M>
+M
+transpose (const M& A)
+{
+    M T;
+    T.nrows = A.ncols;
+    T.ncols = A.nrows;
+    T.ptr.assign(T.nrows+1, 0);
+    const int nnz = A.ptr[A.nrows];
+    for (int jj = 0; jj < nnz; ++jj) {
+        ++T.ptr[A.col[jj]+1];
+    }
+    for (int i = 0; i < T.nrows; ++i) {
+        T.ptr[i+1] += T.ptr[i];
+    }
+    T.col.resize(nnz);
+    T.val.resize(nnz);
+    Vector<int> pos(T.ptr.begin(), T.ptr.end()-1);
+    for (int i = 0; i < A.nrows; ++i) {
+        for (int jj = A.ptr[i]; jj < A.ptr[i+1]; ++jj) {
+            const int p = pos[A.col[jj]]++;
+            T.col[p] = i;
+            T.val[p] = A.val[jj];
+        }
+    }
+    return T;
+}
+
+// C = A*B, row by row.  A symbolic pass counts the entries of each row
+// so that the numeric pass can fill the rows in parallel.
+template <class M>
+M
+multiply (const M& A, const M& B)
+{
+    M C;
+    C.nrows = A.nrows;
+    C.ncols = B.ncols;
+    C.ptr.assign(C.nrows+1, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<int> marker(B.ncols, -1);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (int i = 0; i < A.nrows; ++i) {
+            int cnt = 0;
+            for (int jj = A.ptr[i]; jj < A.ptr[i+1]; ++jj) {
+                const int k = A.col[jj];
+                for (int kk = B.ptr[k]; kk < B.ptr[k+1]; ++kk) {
+                    const int j = B.col[kk];
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        ++cnt;
+                    }
+                }
+            }
+            C.ptr[i+1] = cnt;
+        }
+    }
+
+    for (int i = 0; i < C.nrows; ++i) {
+        C.ptr[i+1] += C.ptr[i];
+    }
+    C.col.resize(C.ptr[C.nrows]);
+    C.val.resize(C.ptr[C.nrows]);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<int> marker(B.ncols, -1);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (int i = 0; i < A.nrows; ++i) {
+            const int row_begin = C.ptr[i];
+            int pos = row_begin;
+            for (int jj = A.ptr[i]; jj < A.ptr[i+1]; ++jj) {
+                const int k = A.col[jj];
+                const Real a = A.val[jj];
+                for (int kk = B.ptr[k]; kk < B.ptr[k+1]; ++kk) {
+                    const int j = B.col[kk];
+                    if (marker[j] < row_begin) {
+                        marker[j] = pos;
+                        C.col[pos] = j;
+                        C.val[pos] = a*B.val[kk];
+                        ++pos;
+                    } else {
+                        C.val[marker[j]] += a*B.val[kk];
+                    }
+                }
+            }
+        }
+    }
+
+    return C;
+}
+
+}
+
+MLAMGSolver::MLAMGSolver (const BoxArray& grids, const DistributionMapping& dmap,
+                          const Geometry& geom_, MPI_Comm comm_,
+                          const iMultiFab* overset_mask)
+    : comm(comm_),
+      geom(geom_),
+      m_overset_mask(overset_mask)
+{
+#ifdef BL_USE_MPI
+    MPI_Comm_rank(comm, &m_myproc);
+    MPI_Comm_size(comm, &m_nprocs);
+#endif
+
+    ParmParse pp("amg");
+    pp.query("max_coarse_size", max_coarse_size);
+    pp.query("strong_threshold", strong_threshold);
+    pp.query("num_sweeps", num_sweeps);
+    pp.query("max_levels", max_levels);
+
+    acoefs.define(grids, dmap, 1, 0);
+    acoefs.setVal(0.0);
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bcoefs[idim].define(amrex::convert(grids,IntVect::TheDimensionVector(idim)),
+                            dmap, 1, 0);
+        bcoefs[idim].setVal(0.0);
+    }
+}
+
+MLAMGSolver::~MLAMGSolver ()
+{}
+
+void
+MLAMGSolver::setScalars (Real sa, Real sb)
+{
+    scalar_a = sa;
+    scalar_b = sb;
+    m_coeffs_changed = true;
+}
+
+void
+MLAMGSolver::setACoeffs (const MultiFab& alpha)
+{
+    MultiFab::Copy(acoefs, alpha, 0, 0, 1, 0);
+    m_coeffs_changed = true;
+}
+
+void
+MLAMGSolver::setBCoeffs (const Array<const MultiFab*,AMREX_SPACEDIM>& beta)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        MultiFab::Copy(bcoefs[idim], *beta[idim], 0, 0, 1, 0);
+    }
+    m_coeffs_changed = true;
+}
+
+int
+MLAMGSolver::solve (MultiFab& soln, const MultiFab& rhs, Real rel_tol, Real abs_tol,
+                    int max_iter, const BndryData& bndry, int max_bndry_order)
+{
+    Gpu::LaunchSafeGuard lsg(false);
+
+    BL_PROFILE("MLAMGSolver::solve()");
+
+    m_factory = &(rhs.Factory());
+
+    if (!m_prepared || m_bndry != &bndry || m_maxorder != max_bndry_order)
+    {
+        m_bndry = &bndry;
+        m_maxorder = max_bndry_order;
+        prepareSolver();
+        m_coeffs_changed = true;
+    }
+
+    if (m_coeffs_changed)
+    {
+        loadMatrix();
+        setupHierarchy();
+    }
+
+    const int n = m_levels[0].A.nrows;
+    const int ncomp = rhs.nComp();
+    Vector<Real> x(n), b(n);
+
+    int ret = 0;
+    m_niters = 0;
+    for (int comp = 0; comp < ncomp; ++comp)
+    {
+        gatherVector(rhs, comp, b);
+
+        const Real bnorm = norm_inf(b);
+        const Real eps = std::max(rel_tol*bnorm, abs_tol);
+
+        std::fill(x.begin(), x.end(), 0.0);
+
+        int niters = 0;
+        int r = 0;
+        if (bnorm > 0.0)
+        {
+            if (m_symmetric) {
+                niters = solve_cg(x, b, eps, max_iter);
+            } else {
+                niters = solve_bicgstab(x, b, eps, max_iter);
+            }
+            if (niters < 0) {
+                niters = max_iter;
+                r = 8;
+            }
+        }
+        m_niters += niters;
+        ret = std::max(ret, r);
+
+        if (verbose > 0)
+        {
+            residual(m_levels[0].A, x, b, m_levels[0].r);
+            amrex::Print() << "MLAMGSolver: Final Iter. " << niters
+                           << " resid, resid/bnorm = " << norm_inf(m_levels[0].r)
+                           << ", " << ((bnorm > 0.0) ? norm_inf(m_levels[0].r)/bnorm : 0.0)
+                           << "\n";
+        }
+
+        const int proc_offset = m_proc_offset[m_myproc];
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(soln); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto len = amrex::length(bx);
+            Array4<Real> const& s = soln.array(mfi);
+            const Real* xp = x.data() + proc_offset + offset[mfi];
+            amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+            {
+                s(i,j,k,comp) = xp[((k-lo.z)*len.y + (j-lo.y))*len.x + (i-lo.x)];
+            });
+        }
+    }
+
+    if (ret != 0 && verbose > 0)
+    {
+        amrex::Warning("MLAMGSolver: failed to converge!");
+    }
+
+    return ret;
+}
+
+bool
+MLAMGSolver::hasCutCells (const FabFactory<FArrayBox>* factory)
+{
+#ifdef AMREX_USE_EB
+    auto ebfactory = dynamic_cast<EBFArrayBoxFactory const*>(factory);
+    return ebfactory && !ebfactory->isAllRegular();
+#else
+    amrex::ignore_unused(factory);
+    return false;
+#endif
+}
+
+void
+MLAMGSolver::prepareSolver ()
+{
+    BL_PROFILE("MLAMGSolver::prepareSolver()");
+
+    const BoxArray& ba = acoefs.boxArray();
+    const DistributionMapping& dm = acoefs.DistributionMap();
+
+    if (hasCutCells(m_factory)) {
+        amrex::Abort("MLAMGSolver: cut cells are not supported");
+    }
+
+    // Cells are numbered box by box with i running fastest.
+    offset.define(ba, dm);
+    Long ncells_proc = 0;
+    for (MFIter mfi(acoefs); mfi.isValid(); ++mfi) {
+        offset[mfi] = static_cast<int>(ncells_proc);
+        ncells_proc += mfi.validbox().numPts();
+    }
+
+    const int nprocs = m_nprocs;
+    Vector<Long> ncells_allprocs(nprocs, 0);
+#ifdef BL_USE_MPI
+    MPI_Allgather(&ncells_proc, 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                  ncells_allprocs.data(), 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                  comm);
+#else
+    ncells_allprocs[0] = ncells_proc;
+#endif
+
+    m_proc_offset.assign(nprocs+1, 0);
+    Long ncells_total = 0;
+    for (int i = 0; i < nprocs; ++i) {
+        m_proc_offset[i] = static_cast<int>(ncells_total);
+        ncells_total += ncells_allprocs[i];
+    }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ncells_total < static_cast<Long>(std::numeric_limits<int>::max()),
+                                     "MLAMGSolver: too many cells");
+    m_proc_offset[nprocs] = static_cast<int>(ncells_total);
+
+    const int proc_offset = m_proc_offset[m_myproc];
+
+    cell_id.define(ba, dm, 1, 1);
+    cell_id.setVal(-1);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(cell_id); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+        Array4<int> const& id = cell_id.array(mfi);
+        const int id0 = proc_offset + offset[mfi];
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            id(i,j,k) = id0 + ((k-lo.z)*len.y + (j-lo.y))*len.x + (i-lo.x);
+        });
+    }
+    cell_id.FillBoundary(geom.periodicity());
+
+    m_prepared = true;
+}
+
+void
+MLAMGSolver::loadMatrix ()
+{
+    BL_PROFILE("MLAMGSolver::loadMatrix()");
+
+    constexpr int stencil_size = 2*AMREX_SPACEDIM+1;
+
+    const int myproc = m_myproc;
+    const int nprocs = m_nprocs;
+    const int nrows_proc = m_proc_offset[myproc+1] - m_proc_offset[myproc];
+
+    const Real* dx = geom.CellSize();
+    const int bho = (m_maxorder > 2) ? 1 : 0;
+    GpuArray<Real,AMREX_SPACEDIM> fac;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        fac[idim] = scalar_b/(dx[idim]*dx[idim]);
+    }
+
+    // Fixed width rows first.  Neighbors outside the grids have column -1.
+    Vector<int> cols(nrows_proc*stencil_size, -1);
+    Vector<Real> vals(nrows_proc*stencil_size, 0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(acoefs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+
+        // Boundary factors as in the IJ interface of Hypre.  bf1 goes to
+        // the diagonal and bf2 to the next cell inside.
+        GpuArray<Real,2*AMREX_SPACEDIM> bf1, bf2;
+        const Vector< Vector<BoundCond> >& bcs = m_bndry->bndryConds(mfi);
+        const BndryData::RealTuple& bcl = m_bndry->bndryLocs(mfi);
+        for (OrientationIter oit; oit; ++oit)
+        {
+            const int cdir = oit();
+            const int idim = oit().coordDir();
+            const Real h = dx[idim];
+            bf1[cdir] = 0.0;
+            bf2[cdir] = 0.0;
+            if (bcs[cdir][0] == AMREX_LO_DIRICHLET) {
+                const Real h2 = 0.5*h;
+                if (bho >= 1) {
+                    const Real h3 = 3.0*h2;
+                    bf1[cdir] = fac[idim] * ((h3 - bcl[cdir]) / (bcl[cdir] + h2) - 1.0);
+                    bf2[cdir] = fac[idim] * (bcl[cdir] - h2) / (bcl[cdir] + h3);
+                } else {
+                    bf1[cdir] = fac[idim] * ( h / (bcl[cdir] + h2) - 1.0);
+                }
+            } else if (bcs[cdir][0] == AMREX_LO_NEUMANN) {
+                bf1[cdir] = -fac[idim];
+            } else if (bcs[cdir][0] == AMREX_LO_REFLECT_ODD) {
+                bf1[cdir] = fac[idim];
+            }
+        }
+
+        Array4<int const> const& id = cell_id.const_array(mfi);
+        Array4<Real const> const& a = acoefs.const_array(mfi);
+        GpuArray<Array4<Real const>,AMREX_SPACEDIM> b{{AMREX_D_DECL(bcoefs[0].const_array(mfi),
+                                                                    bcoefs[1].const_array(mfi),
+                                                                    bcoefs[2].const_array(mfi))}};
+        Array4<int const> const& osm = (m_overset_mask) ? m_overset_mask->const_array(mfi)
+                                                        : Array4<int const>{};
+        const Real sa = scalar_a;
+        int* colp = cols.data() + offset[mfi]*stencil_size;
+        Real* valp = vals.data() + offset[mfi]*stencil_size;
+
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            const int irow = ((k-lo.z)*len.y + (j-lo.y))*len.x + (i-lo.x);
+            int* c = colp + irow*stencil_size;
+            Real* v = valp + irow*stencil_size;
+            c[0] = id(i,j,k);
+            if (osm and osm(i,j,k) == 0) {
+                v[0] = 1.0;
+                return;
+            }
+            v[0] = sa*a(i,j,k);
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                const IntVect ivlo = iv - IntVect::TheDimensionVector(idim);
+                const IntVect ivhi = iv + IntVect::TheDimensionVector(idim);
+                const Real blo = b[idim](iv);
+                const Real bhi = b[idim](ivhi);
+                v[0] += fac[idim]*(blo + bhi);
+                c[1+2*idim] = id(ivlo);
+                v[1+2*idim] = -fac[idim]*blo;
+                c[2+2*idim] = id(ivhi);
+                v[2+2*idim] = -fac[idim]*bhi;
+                const int ilo = idim;
+                const int ihi = idim + AMREX_SPACEDIM;
+                if (iv[idim] == bx.smallEnd(idim) && id(ivlo) < 0) {
+                    v[0] += bf1[ilo]*blo;
+                    v[2+2*idim] += bf2[ilo]*blo;
+                }
+                if (iv[idim] == bx.bigEnd(idim) && id(ivhi) < 0) {
+                    v[0] += bf1[ihi]*bhi;
+                    v[1+2*idim] += bf2[ihi]*bhi;
+                }
+            }
+        });
+    }
+
+    // Compress into sorted rows.
+    Vector<int> nnz_row(nrows_proc);
+    Vector<int> loc_col;
+    Vector<Real> loc_val;
+    loc_col.reserve(cols.size());
+    loc_val.reserve(vals.size());
+    for (int i = 0; i < nrows_proc; ++i)
+    {
+        int* c = cols.data() + i*stencil_size;
+        Real* v = vals.data() + i*stencil_size;
+        for (int s = 1; s < stencil_size; ++s) {
+            for (int t = s; t > 0 && c[t] < c[t-1]; --t) {
+                std::swap(c[t], c[t-1]);
+                std::swap(v[t], v[t-1]);
+            }
+        }
+        int cnt = 0;
+        for (int s = 0; s < stencil_size; ++s) {
+            if (c[s] >= 0) {
+                loc_col.push_back(c[s]);
+                loc_val.push_back(v[s]);
+                ++cnt;
+            }
+        }
+        nnz_row[i] = cnt;
+    }
+
+    // Every process gets the whole matrix.
+    CSRMatrix A;
+    A.nrows = m_proc_offset[nprocs];
+    A.ncols = A.nrows;
+    A.ptr.assign(A.nrows+1, 0);
+
+#ifdef BL_USE_MPI
+    {
+        Vector<int> rcnts(nprocs), rdispls(nprocs);
+        for (int i = 0; i < nprocs; ++i) {
+            rcnts[i] = m_proc_offset[i+1] - m_proc_offset[i];
+            rdispls[i] = m_proc_offset[i];
+        }
+        MPI_Allgatherv(nnz_row.data(), nrows_proc, ParallelDescriptor::Mpi_typemap<int>::type(),
+                       A.ptr.data()+1, rcnts.data(), rdispls.data(), ParallelDescriptor::Mpi_typemap<int>::type(), comm);
+    }
+#else
+    std::copy(nnz_row.begin(), nnz_row.end(), A.ptr.begin()+1);
+#endif
+    for (int i = 0; i < A.nrows; ++i) {
+        A.ptr[i+1] += A.ptr[i];
+    }
+    A.col.resize(A.ptr[A.nrows]);
+    A.val.resize(A.ptr[A.nrows]);
+
+#ifdef BL_USE_MPI
+    {
+        Vector<int> rcnts(nprocs), rdispls(nprocs);
+        for (int i = 0; i < nprocs; ++i) {
+            rdispls[i] = A.ptr[m_proc_offset[i]];
+            rcnts[i] = A.ptr[m_proc_offset[i+1]] - rdispls[i];
+        }
+        MPI_Allgatherv(loc_col.data(), loc_col.size(), ParallelDescriptor::Mpi_typemap<int>::type(),
+                       A.col.data(), rcnts.data(), rdispls.data(), ParallelDescriptor::Mpi_typemap<int>::type(), comm);
+        MPI_Allgatherv(loc_val.data(), loc_val.size(), ParallelDescriptor::Mpi_typemap<Real>::type(),
+                       A.val.data(), rcnts.data(), rdispls.data(),
+                       ParallelDescriptor::Mpi_typemap<Real>::type(), comm);
+    }
+#else
+    A.col = std::move(loc_col);
+    A.val = std::move(loc_val);
+#endif
+
+    // The rows are sorted, so the matrix is symmetric iff it equals its
+    // transpose entry by entry.
+    {
+        CSRMatrix T = transpose(A);
+        m_symmetric = (T.col == A.col);
+        if (m_symmetric) {
+            for (int jj = 0, nnz = A.ptr[A.nrows]; jj < nnz; ++jj) {
+                if (std::abs(T.val[jj] - A.val[jj]) > 1.e-12*std::abs(A.val[jj])) {
+                    m_symmetric = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    m_levels.clear();
+    m_levels.resize(1);
+    m_levels[0].A = std::move(A);
+
+    m_coeffs_changed = false;
+}
+
+int
+MLAMGSolver::aggregate (const CSRMatrix& A, Vector<int>& agg) const
+{
+    const int n = A.nrows;
+
+    Vector<Real> diag(n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int jj = A.ptr[i]; jj < A.ptr[i+1]; ++jj) {
+            if (A.col[jj] == i) diag[i] = A.val[jj];
+        }
+    }
+
+    // Strong connections: |a_ij| >= theta * sqrt(|a_ii*a_jj|)
+    Vector<int> sptr(n+1, 0);
+    Vector<int> scol;
+    scol.reserve(A.ptr[n]);
+    const Real theta = strong_threshold;
+    for (int i = 0; i < n; ++i) {
+        for (int jj = A.ptr[i]; jj < A.ptr[i+1]; ++jj) {
+            const int j = A.col[jj];
+            if (j != i && A.val[jj] != 0.0 &&
+                std::abs(A.val[jj]) >= theta*std::sqrt(std::abs(diag[i]*diag[j]))) {
+                scol.push_back(j);
+            }
+        }
+        sptr[i+1] = scol.size();
+    }
+
+    // -1: not yet aggregated, -2: isolated and left to the smoother.
+    agg.assign(n, -1);
+    for (int i = 0; i < n; ++i) {
+        if (sptr[i] == sptr[i+1]) agg[i] = -2;
+    }
+
+    int nagg = 0;
+
+    // Pass 1: aggregates of a cell and all its strong neighbors, if none
+    // of them is taken yet.
+    for (int i = 0; i < n; ++i) {
+        if (agg[i] != -1) continue;
+        bool free = true;
+        for (int jj = sptr[i]; jj < sptr[i+1]; ++jj) {
+            if (agg[scol[jj]] != -1) {
+                free = false;
+                break;
+            }
+        }
+        if (free) {
+            agg[i] = nagg;
+            for (int jj = sptr[i]; jj < sptr[i+1]; ++jj) {
+                agg[scol[jj]] = nagg;
+            }
+            ++nagg;
+        }
+    }
+
+    // Pass 2: join a neighboring aggregate from pass 1.
+    const Vector<int> agg1 = agg;
+    for (int i = 0; i < n; ++i) {
+        if (agg[i] != -1) continue;
+        for (int jj = sptr[i]; jj < sptr[i+1]; ++jj) {
+            if (agg1[scol[jj]] >= 0) {
+                agg[i] = agg1[scol[jj]];
+                break;
+            }
+        }
+    }
+
+    // Pass 3: whatever is left forms new aggregates.
+    for (int i = 0; i < n; ++i) {
+        if (agg[i] != -1) continue;
+        agg[i] = nagg;
+        for (int jj = sptr[i]; jj < sptr[i+1]; ++jj) {
+            if (agg[scol[jj]] == -1) agg[scol[jj]] = nagg;
+        }
+        ++nagg;
+    }
+
+    return nagg;
+}
+
+void
+MLAMGSolver::setupHierarchy ()
+{
+    BL_PROFILE("MLAMGSolver::setupHierarchy()");
+
+    for (int lev = 0; ; ++lev)
+    {
+        {
+            Level& L = m_levels[lev];
+            const CSRMatrix& A = L.A;
+            const int n = A.nrows;
+
+            L.dinv.assign(n, 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int i = 0; i < n; ++i) {
+                for (int jj = A.ptr[i]; jj < A.ptr[i+1]; ++jj) {
+                    if (A.col[jj] == i && A.val[jj] != 0.0) L.dinv[i] = 1.0/A.val[jj];
+                }
+            }
+
+            L.x.resize(n);
+            L.b.resize(n);
+            L.r.resize(n);
+
+            // Weight 4/(3 rho) for smoothing the prolongation, with rho, the
+            // spectral radius of D^-1 A, estimated by power iteration.
+            Real rho = 0.0;
+            {
+                Vector<Real>& v = L.x;
+                Vector<Real>& w = L.r;
+                for (int i = 0; i < n; ++i) {
+                    v[i] = static_cast<Real>((static_cast<Long>(i)*7919) % 101)/50.5 - 1.0;
+                }
+                for (int it = 0; it < 15; ++it) {
+                    const Real vnorm = std::sqrt(dotxy(v,v));
+                    spmv(A, v, w);
+                    for (int i = 0; i < n; ++i) {
+                        w[i] *= L.dinv[i] / vnorm;
+                    }
+                    rho = std::sqrt(dotxy(w,w));
+                    std::swap(v, w);
+                }
+                // v and w are the level's x and r, which were swapped an
+                // odd number of times; the contents are scratch either way.
+            }
+            L.omega = (rho > 0.0) ? 4.0/(3.0*rho) : 1.0;
+
+            if (n <= max_coarse_size || lev+1 >= max_levels) break;
+        }
+
+        Vector<int> agg;
+        const int nagg = aggregate(m_levels[lev].A, agg);
+        if (nagg == 0 || nagg > 0.8*m_levels[lev].A.nrows) break;
+
+        Level& L = m_levels[lev];
+        const CSRMatrix& A = L.A;
+        const int n = A.nrows;
+
+        // Tentative prolongation: piecewise constant on the aggregates,
+        // with orthonormal columns.
+        Vector<int> aggsize(nagg, 0);
+        for (int i = 0; i < n; ++i) {
+            if (agg[i] >= 0) ++aggsize[agg[i]];
+        }
+        CSRMatrix T;
+        T.nrows = n;
+        T.ncols = nagg;
+        T.ptr.resize(n+1);
+        T.ptr[0] = 0;
+        for (int i = 0; i < n; ++i) {
+            T.ptr[i+1] = T.ptr[i];
+            if (agg[i] >= 0) {
+                T.col.push_back(agg[i]);
+                T.val.push_back(1.0/std::sqrt(static_cast<Real>(aggsize[agg[i]])));
+                ++T.ptr[i+1];
+            }
+        }
+
+        // Smoothed prolongation P = (I - omega D^-1 A) T.  The pattern
+        // of A*T includes that of T.
+        L.P = multiply(A, T);
+        {
+            CSRMatrix& P = L.P;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int i = 0; i < n; ++i) {
+                const Real f = -L.omega*L.dinv[i];
+                for (int jj = P.ptr[i]; jj < P.ptr[i+1]; ++jj) {
+                    P.val[jj] *= f;
+                    if (agg[i] >= 0 && P.col[jj] == agg[i]) {
+                        P.val[jj] += T.val[T.ptr[i]];
+                    }
+                }
+            }
+        }
+        L.R = transpose(L.P);
+
+        CSRMatrix Ac = multiply(L.R, multiply(A, L.P));
+
+        m_levels.emplace_back();
+        m_levels.back().A = std::move(Ac);
+    }
+
+    setupCoarsest();
+
+    if (verbose > 0)
+    {
+        Long nnz = 0;
+        for (const auto& L : m_levels) nnz += L.A.ptr[L.A.nrows];
+        amrex::Print() << "MLAMGSolver: " << m_levels.size() << " levels, "
+                       << m_levels[0].A.nrows << " -> " << m_levels.back().A.nrows
+                       << " unknowns, operator complexity "
+                       << static_cast<Real>(nnz)/m_levels[0].A.ptr[m_levels[0].A.nrows]
+                       << (m_symmetric ? ", CG" : ", BiCGStab") << "\n";
+    }
+}
+
+void
+MLAMGSolver::setupCoarsest ()
+{
+    const CSRMatrix& A = m_levels.back().A;
+    const int n = A.nrows;
+    m_ncoarsest = n;
+    m_coarsest_direct = (n <= max_coarse_size);
+    if (!m_coarsest_direct) return;
+
+    m_lu.assign(static_cast<Long>(n)*n, 0.0);
+    m_piv.resize(n);
+    m_zero_pivot.assign(n, 0);
+
+    Real maxabs = 0.0;
+    for (int i = 0; i < n; ++i) {
+        for (int jj = A.ptr[i]; jj < A.ptr[i+1]; ++jj) {
+            m_lu[static_cast<Long>(i)*n+A.col[jj]] += A.val[jj];
+            maxabs = std::max(maxabs, std::abs(A.val[jj]));
+        }
+    }
+
+    const Real tol = (is_matrix_singular)
+        ? std::sqrt(std::numeric_limits<Real>::epsilon())*maxabs : 0.0;
+
+    Real* AMREX_RESTRICT lu = m_lu.data();
+    for (int k = 0; k < n; ++k)
+    {
+        int p = k;
+        for (int i = k+1; i < n; ++i) {
+            if (std::abs(lu[static_cast<Long>(i)*n+k]) > std::abs(lu[static_cast<Long>(p)*n+k])) {
+                p = i;
+            }
+        }
+        m_piv[k] = p;
+        if (p != k) {
+            std::swap_ranges(lu+static_cast<Long>(k)*n, lu+static_cast<Long>(k+1)*n,
+                             lu+static_cast<Long>(p)*n);
+        }
+
+        const Real pivot = lu[static_cast<Long>(k)*n+k];
+        if (std::abs(pivot) <= tol) {
+            m_zero_pivot[k] = 1;
+            for (int i = k+1; i < n; ++i) {
+                lu[static_cast<Long>(i)*n+k] = 0.0;
+            }
+            continue;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = k+1; i < n; ++i) {
+            Real* AMREX_RESTRICT row = lu + static_cast<Long>(i)*n;
+            const Real* AMREX_RESTRICT rowk = lu + static_cast<Long>(k)*n;
+            const Real l = row[k] / pivot;
+            row[k] = l;
+            if (l != 0.0) {
+                for (int j = k+1; j < n; ++j) {
+                    row[j] -= l*rowk[j];
+                }
+            }
+        }
+    }
+}
+
+void
+MLAMGSolver::coarsestSolve ()
+{
+    Level& L = m_levels.back();
+    const int n = m_ncoarsest;
+
+    if (!m_coarsest_direct)
+    {
+        const int lev = m_levels.size()-1;
+        std::fill(L.x.begin(), L.x.end(), 0.0);
+        for (int s = 0; s < 4*num_sweeps; ++s) {
+            relax(lev, true);
+            relax(lev, false);
+        }
+        return;
+    }
+
+    Vector<Real>& x = L.x;
+    x = L.b;
+    for (int k = 0; k < n; ++k) {
+        if (m_piv[k] != k) std::swap(x[k], x[m_piv[k]]);
+    }
+    const Real* lu = m_lu.data();
+    for (int i = 1; i < n; ++i) {
+        const Real* row = lu + static_cast<Long>(i)*n;
+        Real s = x[i];
+        for (int j = 0; j < i; ++j) {
+            s -= row[j]*x[j];
+        }
+        x[i] = s;
+    }
+    for (int i = n-1; i >= 0; --i) {
+        if (m_zero_pivot[i]) {
+            x[i] = 0.0;
+            continue;
+        }
+        const Real* row = lu + static_cast<Long>(i)*n;
+        Real s = x[i];
+        for (int j = i+1; j < n; ++j) {
+            s -= row[j]*x[j];
+        }
+        x[i] = s/row[i];
+    }
+}
+
+void
+MLAMGSolver::vcycle (int lev)
+{
+    if (lev == static_cast<int>(m_levels.size())-1) {
+        coarsestSolve();
+        return;
+    }
+
+    Level& L = m_levels[lev];
+    Level& C = m_levels[lev+1];
+
+    std::fill(L.x.begin(), L.x.end(), 0.0);
+    for (int s = 0; s < num_sweeps; ++s) {
+        relax(lev, true);
+    }
+
+    residual(L.A, L.x, L.b, L.r);
+    spmv(L.R, L.r, C.b);
+    vcycle(lev+1);
+    spmv(L.P, C.x, L.r);
+    axpy(L.x, 1.0, L.r);
+
+    for (int s = 0; s < num_sweeps; ++s) {
+        relax(lev, false);
+    }
+}
+
+void
+MLAMGSolver::relax (int lev, bool forward)
+{
+    Level& L = m_levels[lev];
+    const int n = L.A.nrows;
+    const int* AMREX_RESTRICT ptr = L.A.ptr.data();
+    const int* AMREX_RESTRICT col = L.A.col.data();
+    const Real* AMREX_RESTRICT val = L.A.val.data();
+    const Real* AMREX_RESTRICT dinv = L.dinv.data();
+    const Real* AMREX_RESTRICT b = L.b.data();
+    Real* AMREX_RESTRICT x = L.x.data();
+
+    // Values from other blocks are taken from before the sweep.
+    L.r = L.x;
+    const Real* AMREX_RESTRICT xold = L.r.data();
+
+    const int nblocks = (n + relax_block_size - 1) / relax_block_size;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ib = 0; ib < nblocks; ++ib)
+    {
+        const int ilo = ib*relax_block_size;
+        const int ihi = std::min(n, ilo+relax_block_size);
+        for (int ii = 0; ii < ihi-ilo; ++ii)
+        {
+            const int i = (forward) ? ilo+ii : ihi-1-ii;
+            Real s = b[i];
+            for (int jj = ptr[i]; jj < ptr[i+1]; ++jj) {
+                const int j = col[jj];
+                if (j != i) {
+                    s -= val[jj] * ((j >= ilo && j < ihi) ? x[j] : xold[j]);
+                }
+            }
+            x[i] = s*dinv[i];
+        }
+    }
+}
+
+void
+MLAMGSolver::precond (Vector<Real>& z, const Vector<Real>& r)
+{
+    m_levels[0].b = r;
+    vcycle(0);
+    z = m_levels[0].x;
+}
+
+int
+MLAMGSolver::solve_cg (Vector<Real>& x, const Vector<Real>& b, Real eps, int max_iter)
+{
+    const int n = b.size();
+    const CSRMatrix& A = m_levels[0].A;
+    Vector<Real> r(b), z(n), p(n), q(n);
+
+    precond(z, r);
+    p = z;
+    Real rho = dotxy(r, z);
+
+    for (int iter = 1; iter <= max_iter; ++iter)
+    {
+        spmv(A, p, q);
+        const Real pq = dotxy(p, q);
+        if (pq == 0.0) return -1;
+        const Real alpha = rho/pq;
+        axpy(x, alpha, p);
+        axpy(r, -alpha, q);
+
+        const Real rnorm = norm_inf(r);
+        if (verbose > 2) {
+            amrex::Print() << "MLAMGSolver_CG: Iter " << iter << " resid " << rnorm << "\n";
+        }
+        if (rnorm <= eps) return iter;
+
+        precond(z, r);
+        const Real rho_new = dotxy(r, z);
+        const Real beta = rho_new/rho;
+        rho = rho_new;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < n; ++i) {
+            p[i] = z[i] + beta*p[i];
+        }
+    }
+
+    return -1;
+}
+
+int
+MLAMGSolver::solve_bicgstab (Vector<Real>& x, const Vector<Real>& b, Real eps, int max_iter)
+{
+    const int n = b.size();
+    const CSRMatrix& A = m_levels[0].A;
+    Vector<Real> r(b), rh(b), p(n, 0.0), v(n, 0.0), ph(n), s(n), sh(n), t(n);
+    Real rho_1 = 0.0, alpha = 0.0, omega = 0.0;
+
+    for (int iter = 1; iter <= max_iter; ++iter)
+    {
+        const Real rho = dotxy(rh, r);
+        if (rho == 0.0) return -1;
+        if (iter == 1) {
+            p = r;
+        } else {
+            const Real beta = (rho/rho_1)*(alpha/omega);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int i = 0; i < n; ++i) {
+                p[i] = r[i] + beta*(p[i] - omega*v[i]);
+            }
+        }
+        precond(ph, p);
+        spmv(A, ph, v);
+        const Real rhv = dotxy(rh, v);
+        if (rhv == 0.0) return -1;
+        alpha = rho/rhv;
+        axpy(x, alpha, ph);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < n; ++i) {
+            s[i] = r[i] - alpha*v[i];
+        }
+
+        if (norm_inf(s) <= eps) return iter;
+
+        precond(sh, s);
+        spmv(A, sh, t);
+        const Real tt = dotxy(t, t);
+        omega = (tt > 0.0) ? dotxy(t, s)/tt : 0.0;
+        if (omega == 0.0) return -1;
+        axpy(x, omega, sh);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < n; ++i) {
+            r[i] = s[i] - omega*t[i];
+        }
+
+        if (norm_inf(r) <= eps) return iter;
+
+        rho_1 = rho;
+    }
+
+    return -1;
+}
+
+void
+MLAMGSolver::gatherVector (const MultiFab& mf, int comp, Vector<Real>& v) const
+{
+    const int myproc = m_myproc;
+    const int nrows_proc = m_proc_offset[myproc+1] - m_proc_offset[myproc];
+    Vector<Real> loc(nrows_proc);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+        Array4<Real const> const& a = mf.const_array(mfi);
+        Array4<int const> const& osm = (m_overset_mask) ? m_overset_mask->const_array(mfi)
+                                                        : Array4<int const>{};
+        Real* lp = loc.data() + offset[mfi];
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            lp[((k-lo.z)*len.y + (j-lo.y))*len.x + (i-lo.x)]
+                = (osm and osm(i,j,k) == 0) ? 0.0 : a(i,j,k,comp);
+        });
+    }
+
+#ifdef BL_USE_MPI
+    const int nprocs = m_nprocs;
+    Vector<int> rcnts(nprocs), rdispls(nprocs);
+    for (int i = 0; i < nprocs; ++i) {
+        rcnts[i] = m_proc_offset[i+1] - m_proc_offset[i];
+        rdispls[i] = m_proc_offset[i];
+    }
+    MPI_Allgatherv(loc.data(), nrows_proc, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                   v.data(), rcnts.data(), rdispls.data(),
+                   ParallelDescriptor::Mpi_typemap<Real>::type(), comm);
+#else
+    v = std::move(loc);
+#endif
+}
+
+}
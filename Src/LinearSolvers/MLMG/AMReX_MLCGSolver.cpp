@@ -49,6 +49,52 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0,nghost);
 }
 
+//
+// Sums and a max reduced in place with non-blocking allreduces, so that
+// the pipelined solvers can apply the operator while they are in flight.
+//
+class IReduce
+{
+public:
+    explicit IReduce (MPI_Comm comm) noexcept : m_comm(comm) {}
+    ~IReduce () { wait(); }
+
+    IReduce (const IReduce&) = delete;
+    IReduce& operator= (const IReduce&) = delete;
+
+    //! Start reducing the local values sums[0:nsums) and mx.
+    void start (Real* sums, int nsums, Real& mx)
+    {
+#ifdef BL_USE_MPI
+        const auto mpi_type = ParallelDescriptor::Mpi_typemap<Real>::type();
+        MPI_Iallreduce(MPI_IN_PLACE, sums, nsums, mpi_type, MPI_SUM, m_comm, &m_req[0]);
+        MPI_Iallreduce(MPI_IN_PLACE, &mx, 1, mpi_type, MPI_MAX, m_comm, &m_req[1]);
+        m_active = true;
+#else
+        amrex::ignore_unused(sums,nsums,mx,m_comm);
+#endif
+    }
+
+    //! Wait for the reduced values.
+    void wait ()
+    {
+#ifdef BL_USE_MPI
+        if (m_active) {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            MPI_Waitall(2, m_req, MPI_STATUSES_IGNORE);
+            m_active = false;
+        }
+#endif
+    }
+
+private:
+    MPI_Comm m_comm;
+#ifdef BL_USE_MPI
+    MPI_Request m_req[2];
+    bool m_active = false;
+#endif
+};
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -71,9 +117,14 @@ MLCGSolver::solve (MultiFab&       sol,
                    Real            eps_rel,
                    Real            eps_abs)
 {
-    if (solver_type == Type::BiCGStab) {
+    switch (solver_type) {
+    case Type::BiCGStab:
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
-    } else {
+    case Type::PipeBiCGStab:
+        return solve_pipebicgstab(sol,rhs,eps_rel,eps_abs);
+    case Type::PipeCG:
+        return solve_pipecg(sol,rhs,eps_rel,eps_abs);
+    default:
         return solve_cg(sol,rhs,eps_rel,eps_abs);
     }
 }
@@ -396,6 +447,388 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+int
+MLCGSolver::solve_pipebicgstab (MultiFab&       sol,
+                                const MultiFab& rhs,
+                                Real            eps_rel,
+                                Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipebicgstab");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // r, w and z are what the operator is applied to.
+    MultiFab r    (ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab w    (ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab y    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+    int ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    IReduce ireduce(Lp.BottomCommunicator());
+
+    //
+    // w = A r and t = A w, with (rh,r) and (rh,w) reduced while t is computed.
+    //
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Lp.normalize(amrlev, mglev, w);
+
+    Real rvals[2] = { dotxy(rh,r,true), dotxy(rh,w,true) };
+    Real rmax = 0.0;
+    ireduce.start(rvals, 2, rmax);
+    Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    Lp.normalize(amrlev, mglev, t);
+    ireduce.wait();
+
+    Real rho = rvals[0];
+    Real alpha = 0, beta = 0, omega = 0;
+    if ( rho == 0 )
+    {
+        ret = 1;
+    }
+    else if ( rvals[1] == 0 )
+    {
+        ret = 2;
+    }
+    else
+    {
+        alpha = rho/rvals[1];
+    }
+
+    //
+    // With s = A p, z = A s, v = A z, w = A r, t = A w and y = A q, this is
+    // BiCGStab with the dot products of each half iteration reduced together
+    // while the operator is applied.
+    //
+    for (; ret == 0 && iter <= maxiter; ++iter)
+    {
+        if ( iter == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(z,t,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(p, p, -omega, s, nghost);
+            sxay(p, r,   beta, p, nghost);
+            sxay(s, s, -omega, z, nghost);
+            sxay(s, w,   beta, s, nghost);
+            sxay(z, z, -omega, v, nghost);
+            sxay(z, t,   beta, z, nghost);
+        }
+        sxay(q, r, -alpha, s, nghost);
+        sxay(y, w, -alpha, z, nghost);
+
+        Real qvals[2] = { dotxy(q,y,true), dotxy(y,y,true) };
+        Real qnorm = norm_inf(q,true);
+        ireduce.start(qvals, 2, qnorm);
+        Lp.apply(amrlev, mglev, v, z, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, v);
+        ireduce.wait();
+
+        sxay(sol, sol, alpha, p, nghost);
+
+        rnorm = qnorm;
+
+        if ( verbose > 2 && ParallelDescriptor::IOProcessor() )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: Half Iter "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( qvals[1] != Real(0.0) )
+        {
+            omega = qvals[0]/qvals[1];
+        }
+        else
+        {
+            ret = 3; break;
+        }
+        sxay(sol, sol, omega, q, nghost);
+        sxay(r,     q, -omega, y, nghost);
+        sxay(t,     t, -alpha, v, nghost);
+        sxay(w,     y, -omega, t, nghost);
+
+        Real svals[4] = { dotxy(rh,r,true), dotxy(rh,w,true), dotxy(rh,s,true), dotxy(rh,z,true) };
+        rnorm = norm_inf(r,true);
+        ireduce.start(svals, 4, rnorm);
+        Lp.apply(amrlev, mglev, t, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, t);
+        ireduce.wait();
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipeBiCGStab: Iteration "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( omega == 0 )
+        {
+            ret = 4; break;
+        }
+        if ( svals[0] == 0 )
+        {
+            ret = 1; break;
+        }
+        beta = (svals[0]/rho)*(alpha/omega);
+        const Real sh = svals[1] + beta*svals[2] - beta*omega*svals[3];
+        if ( sh == 0 )
+        {
+            ret = 2; break;
+        }
+        alpha = svals[0]/sh;
+        rho = svals[0];
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeBiCGStab: Final: Iteration "
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipeBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_pipecg (MultiFab&       sol,
+                          const MultiFab& rhs,
+                          Real            eps_rel,
+                          Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipecg");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // r and w are what the operator is applied to.
+    MultiFab r    (ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab w    (ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    Real       rnorm    = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    Real gamma_1 = 0, alpha = 0;
+    int  ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_PipeCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    IReduce ireduce(Lp.BottomCommunicator());
+
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+    //
+    // With w = A r, s = A p, q = A w and z = A s, this is CG with (r,r),
+    // (w,r) and the norm of r reduced while q is computed.  The norm is of
+    // the residual of the previous iteration.
+    //
+    for (; iter <= maxiter; ++iter)
+    {
+        Real vals[2] = { dotxy(r,r,true), dotxy(w,r,true) };
+        Real rnorm_r = norm_inf(r,true);
+        ireduce.start(vals, 2, rnorm_r);
+        Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        ireduce.wait();
+
+        rnorm = rnorm_r;
+
+        if ( iter > 1 )
+        {
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_pipecg:   Iteration"
+                               << std::setw(4) << iter-1
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) {
+                --iter; break;
+            }
+        }
+
+        const Real gamma = vals[0];
+        if ( gamma == 0 )
+        {
+            ret = 1; break;
+        }
+
+        Real beta = 0;
+        Real pw = vals[1];
+        if ( iter > 1 )
+        {
+            beta = gamma/gamma_1;
+            pw -= beta*gamma/alpha;
+        }
+        if ( pw != Real(0.0) )
+        {
+            alpha = gamma/pw;
+        }
+        else
+        {
+            ret = 1; break;
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_pipecg:"
+                           << " iter " << iter
+                           << " rho " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+
+        if ( iter == 1 )
+        {
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(z, q, beta, z, nghost);
+            sxay(s, w, beta, s, nghost);
+            sxay(p, r, beta, p, nghost);
+        }
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(  r,   r,-alpha, s, nghost);
+        sxay(  w,   w,-alpha, z, nghost);
+
+        gamma_1 = gamma;
+    }
+
+    if ( iter > maxiter )
+    {
+        rnorm = norm_inf(r);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_pipecg: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_pipecg: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
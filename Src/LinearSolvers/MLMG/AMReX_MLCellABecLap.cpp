@@ -114,7 +114,8 @@ MLCellABecLap::applyInhomogNeumannTerm (int amrlev, MultiFab& rhs) const
 
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
         {
-            Array4<Real const> const bfab = (has_bcoef) ? bcoef[idim]->array(mfi) : foo.array();
+            Array4<Real const> const bfab = (has_bcoef)
+                ? mllinop_bcast_comp(bcoef[idim]->const_array(mfi), ncomp) : foo.const_array();
             const Orientation olo(idim,Orientation::low);
             const Orientation ohi(idim,Orientation::high);
             const Box blo = amrex::adjCellLo(vbx, idim);
@@ -227,40 +228,34 @@ MLCellABecLap::applyInhomogNeumannTerm (int amrlev, MultiFab& rhs) const
     }
 }
 
-#ifdef AMREX_USE_HYPRE
-std::unique_ptr<Hypre>
-MLCellABecLap::makeHypre (Hypre::Interface hypre_interface) const
+template <class S>
+void
+MLCellABecLap::loadBottomCoeffs (S& solver) const
 {
     const BoxArray& ba = m_grids[0].back();
     const DistributionMapping& dm = m_dmap[0].back();
-    const Geometry& geom = m_geom[0].back();
     const auto& factory = *(m_factory[0].back());
-    MPI_Comm comm = BottomCommunicator();
 
     const int mglev = NMGLevels(0)-1;
 
-    auto om = getOversetMask(0, mglev);
-
-    auto hypre_solver = amrex::makeHypre(ba, dm, geom, comm, hypre_interface, om);
-
-    hypre_solver->setScalars(getAScalar(), getBScalar());
+    solver.setScalars(getAScalar(), getBScalar());
 
     auto ac = getACoeffs(0, mglev);
     if (ac)
     {
-        hypre_solver->setACoeffs(*ac);
+        solver.setACoeffs(*ac);
     }
     else
     {
         MultiFab alpha(ba,dm,1,0,MFInfo(),factory);
         alpha.setVal(0.0);
-        hypre_solver->setACoeffs(alpha);
+        solver.setACoeffs(alpha);
     }
 
     auto bc = getBCoeffs(0, mglev);
     if (bc[0])
     {
-        hypre_solver->setBCoeffs(bc);
+        solver.setBCoeffs(bc);
     }
     else
     {
@@ -271,14 +266,63 @@ MLCellABecLap::makeHypre (Hypre::Interface hypre_interface) const
                               dm, 1, 0, MFInfo(), factory);
             beta[idim].setVal(1.0);
         }
-        hypre_solver->setBCoeffs(amrex::GetArrOfConstPtrs(beta));
+        solver.setBCoeffs(amrex::GetArrOfConstPtrs(beta));
     }
-    hypre_solver->setIsMatrixSingular(this->isBottomSingular());
+    solver.setIsMatrixSingular(this->isBottomSingular());
+}
+
+#ifdef AMREX_USE_HYPRE
+std::unique_ptr<Hypre>
+MLCellABecLap::makeHypre (Hypre::Interface hypre_interface) const
+{
+    const BoxArray& ba = m_grids[0].back();
+    const DistributionMapping& dm = m_dmap[0].back();
+    const Geometry& geom = m_geom[0].back();
+    MPI_Comm comm = BottomCommunicator();
+
+    const int mglev = NMGLevels(0)-1;
+
+    auto om = getOversetMask(0, mglev);
+
+    auto hypre_solver = amrex::makeHypre(ba, dm, geom, comm, hypre_interface, om);
+
+    updateHypre(*hypre_solver);
 
     return hypre_solver;
 }
+
+void
+MLCellABecLap::updateHypre (Hypre& hypre_solver) const
+{
+    loadBottomCoeffs(hypre_solver);
+}
 #endif
 
+std::unique_ptr<MLAMGSolver>
+MLCellABecLap::makeAMG () const
+{
+    const BoxArray& ba = m_grids[0].back();
+    const DistributionMapping& dm = m_dmap[0].back();
+    const Geometry& geom = m_geom[0].back();
+    MPI_Comm comm = BottomCommunicator();
+
+    const int mglev = NMGLevels(0)-1;
+
+    auto om = getOversetMask(0, mglev);
+
+    std::unique_ptr<MLAMGSolver> amg_solver(new MLAMGSolver(ba, dm, geom, comm, om));
+
+    updateAMG(*amg_solver);
+
+    return amg_solver;
+}
+
+void
+MLCellABecLap::updateAMG (MLAMGSolver& amg_solver) const
+{
+    loadBottomCoeffs(amg_solver);
+}
+
 #ifdef AMREX_USE_PETSC
 std::unique_ptr<PETScABecLap>
 MLCellABecLap::makePETSc () const
@@ -286,7 +330,6 @@ MLCellABecLap::makePETSc () const
     const BoxArray& ba = m_grids[0].back();
     const DistributionMapping& dm = m_dmap[0].back();
     const Geometry& geom = m_geom[0].back();
-    const auto& factory = *(m_factory[0].back());
     MPI_Comm comm = BottomCommunicator();
     
     auto petsc_solver = makePetsc(ba, dm, geom, comm);
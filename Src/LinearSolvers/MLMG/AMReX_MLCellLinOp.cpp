@@ -576,6 +576,214 @@ MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     }
 }
 
+void
+MLCellLinOp::smoothSingle (int amrlev, int mglev, FMultiFab& sol, const FMultiFab& rhs,
+                           bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::smoothSingle()");
+    for (int redblack = 0; redblack < 2; ++redblack)
+    {
+        applyBCSingle(amrlev, mglev, sol, skip_fillboundary);
+        FsmoothSingle(amrlev, mglev, sol, rhs, redblack);
+        skip_fillboundary = false;
+    }
+}
+
+void
+MLCellLinOp::correctionResidualSingle (int amrlev, int mglev, FMultiFab& resid, FMultiFab& x,
+                                       const FMultiFab& b) const
+{
+    BL_PROFILE("MLCellLinOp::correctionResidualSingle()");
+    const int ncomp = getNComp();
+    applyBCSingle(amrlev, mglev, x);
+    FapplySingle(amrlev, mglev, resid, x);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(resid,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<float> const& rfab = resid.array(mfi);
+        Array4<float const> const& bfab = b.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            rfab(i,j,k,n) = bfab(i,j,k,n) - rfab(i,j,k,n);
+        });
+    }
+}
+
+void
+MLCellLinOp::restrictionSingle (int amrlev, int cmglev, FMultiFab& crse, FMultiFab& fine) const
+{
+    BL_PROFILE("MLCellLinOp::restrictionSingle()");
+    const int ncomp = getNComp();
+    IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[cmglev-1];
+    Dim3 ratio3 = {1,1,1};
+    AMREX_D_TERM(ratio3.x = ratio[0];,
+                 ratio3.y = ratio[1];,
+                 ratio3.z = ratio[2];);
+    const Real volfrac = Real(1.0)/static_cast<Real>(ratio3.x*ratio3.y*ratio3.z);
+
+    // With agglomeration or consolidation the coarse MG level does not
+    // have the coarsened fine BoxArray.
+    FMultiFab ctmp;
+    FMultiFab* pcrse = &crse;
+    if (!isMFIterSafe(crse, fine)) {
+        ctmp.define(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(), ncomp, 0);
+        pcrse = &ctmp;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*pcrse,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<float> const& cfab = pcrse->array(mfi);
+        Array4<float const> const& ffab = fine.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            Real c = 0.;
+            for (int kref = 0; kref < ratio3.z; ++kref) {
+            for (int jref = 0; jref < ratio3.y; ++jref) {
+            for (int iref = 0; iref < ratio3.x; ++iref) {
+                c += ffab(i*ratio3.x+iref, j*ratio3.y+jref, k*ratio3.z+kref, n);
+            }}}
+            cfab(i,j,k,n) = static_cast<float>(volfrac*c);
+        });
+    }
+
+    if (pcrse != &crse) {
+        crse.ParallelCopy(ctmp, 0, 0, ncomp);
+    }
+}
+
+void
+MLCellLinOp::interpolationSingle (int amrlev, int fmglev, FMultiFab& fine, const FMultiFab& crse) const
+{
+    BL_PROFILE("MLCellLinOp::interpolationSingle()");
+    const int ncomp = getNComp();
+
+    Dim3 ratio3 = {2,2,2};
+    IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[fmglev];
+    AMREX_D_TERM(ratio3.x = ratio[0];,
+                 ratio3.y = ratio[1];,
+                 ratio3.z = ratio[2];);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(fine,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx    = mfi.tilebox();
+        Array4<float const> const& cfab = crse.const_array(mfi);
+        Array4<float> const& ffab = fine.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FUSIBLE ( bx, ncomp, i, j, k, n,
+        {
+            int ic = amrex::coarsen(i,ratio3.x);
+            int jc = amrex::coarsen(j,ratio3.y);
+            int kc = amrex::coarsen(k,ratio3.z);
+            ffab(i,j,k,n) += cfab(ic,jc,kc,n);
+        });
+    }
+}
+
+void
+MLCellLinOp::applyBCSingle (int amrlev, int mglev, FMultiFab& in, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::applyBCSingle()");
+    AMREX_ALWAYS_ASSERT(isCrossStencil() && !isTensorOp());
+
+    const int ncomp = getNComp();
+    if (!skip_fillboundary) {
+        in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(), true);
+    }
+
+    const int flagbc = 0;
+    const int imaxorder = maxorder;
+
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+    const Real dxi = dxinv[0];
+    const Real dyi = (AMREX_SPACEDIM >= 2) ? dxinv[1] : 1.0;
+    const Real dzi = (AMREX_SPACEDIM == 3) ? dxinv[2] : 1.0;
+
+    const auto& maskvals = m_maskvals[amrlev][mglev];
+    const auto& bcondloc = *m_bcondloc[amrlev][mglev];
+
+    // Not used by the homogeneous BC
+    Array4<Real const> foo;
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.SetDynamic(true);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(in, mfi_info); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx   = mfi.validbox();
+        const auto& iofab = in.array(mfi);
+
+        const auto & bdlv = bcondloc.bndryLocs(mfi);
+        const auto & bdcv = bcondloc.bndryConds(mfi);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Orientation olo(idim,Orientation::low);
+            const Orientation ohi(idim,Orientation::high);
+            const Box blo = amrex::adjCellLo(vbx, idim);
+            const Box bhi = amrex::adjCellHi(vbx, idim);
+            const int blen = vbx.length(idim);
+            const auto& mlo = maskvals[olo].array(mfi);
+            const auto& mhi = maskvals[ohi].array(mfi);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                const BoundCond bctlo = bdcv[icomp][olo];
+                const BoundCond bcthi = bdcv[icomp][ohi];
+                const Real bcllo = bdlv[icomp][olo];
+                const Real bclhi = bdlv[icomp][ohi];
+                if (idim == 0) {
+                    AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_x(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dxi, flagbc, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_x(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dxi, flagbc, icomp);
+                    });
+                } else if (idim == 1) {
+                    AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_y(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dyi, flagbc, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_y(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dyi, flagbc, icomp);
+                    });
+                } else {
+                    AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_z(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dzi, flagbc, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_z(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dzi, flagbc, icomp);
+                    });
+                }
+            }
+        }
+    }
+}
+
 void
 MLCellLinOp::reflux (int crse_amrlev,
                      MultiFab& res, const MultiFab& crse_sol, const MultiFab&,
@@ -115,6 +115,7 @@ MLEBABecLap::setScalars (Real a, Real b)
             m_a_coeffs[amrlev][0].setVal(0.0);
         }
     }
+    m_needs_update = true;
 }
 
 void
@@ -1742,6 +1743,16 @@ MLEBABecLap::getEBFluxes (const Vector<MultiFab*>& a_flux, const Vector<MultiFab
     }
 }
 
+std::unique_ptr<MLAMGSolver>
+MLEBABecLap::makeAMG () const
+{
+    if (MLAMGSolver::hasCutCells(m_factory[0].back().get())) {
+        amrex::Abort("MLEBABecLap: bottom_solver amg does not support cut cells, "
+                     "use bicgstab, cg or hypre instead");
+    }
+    return MLCellABecLap::makeAMG();
+}
+
 #ifdef AMREX_USE_HYPRE
 std::unique_ptr<Hypre>
 MLEBABecLap::makeHypre (Hypre::Interface hypre_interface) const
@@ -1751,6 +1762,14 @@ MLEBABecLap::makeHypre (Hypre::Interface hypre_interface) const
     ijmatrix_solver->setEBDirichlet(m_eb_b_coeffs[0].back().get());
     return hypre_solver;
 }
+
+void
+MLEBABecLap::updateHypre (Hypre& hypre_solver) const
+{
+    MLCellABecLap::updateHypre(hypre_solver);
+    auto& ijmatrix_solver = dynamic_cast<HypreABecLap3&>(hypre_solver);
+    ijmatrix_solver.setEBDirichlet(m_eb_b_coeffs[0].back().get());
+}
 #endif
 
 #ifdef AMREX_USE_PETSC
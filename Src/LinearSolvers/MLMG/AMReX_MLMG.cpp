@@ -62,7 +62,8 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         bottom_solver = linop.getDefaultBottomSolver();
     }
 
-    if (bottom_solver == BottomSolver::hypre || bottom_solver == BottomSolver::petsc) {
+    if (bottom_solver == BottomSolver::hypre || bottom_solver == BottomSolver::petsc ||
+        bottom_solver == BottomSolver::amg) {
         int mo = linop.getMaxOrder();
         if (a_sol[0]->hasEBFabFactory()) {
             linop.setMaxOrder(2);
@@ -86,35 +87,73 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
     int ncomp = linop.getNComp();
 
-    bool local = true;
-    Real resnorm0 = MLResNormInf(finest_amr_lev, local); 
-    Real rhsnorm0 = MLRhsNormInf(local); 
-    if (!is_nsolve) {
-        ParallelAllReduce::Max<Real>({resnorm0, rhsnorm0}, ParallelContext::CommunicatorSub());
+    // A batch of right-hand sides has norms and a convergence test for
+    // every component.  Otherwise the components are tested together.
+    const int nnorms = linop.isBatched() ? ncomp : 1;
 
-        if (verbose >= 1)
-        {
-            amrex::Print() << "MLMG: Initial rhs               = " << rhsnorm0 << "\n"
-                           << "MLMG: Initial residual (resid0) = " << resnorm0 << "\n";
-        }
+    Vector<Real> resnorm0 = MLResNormInfs(finest_amr_lev, nnorms);
+    Vector<Real> rhsnorm0 = MLRhsNormInfs(nnorms);
+    if (!is_nsolve) {
+        Vector<Real> tmp(resnorm0);
+        tmp.insert(tmp.end(), rhsnorm0.begin(), rhsnorm0.end());
+        ParallelAllReduce::Max(tmp.data(), 2*nnorms, ParallelContext::CommunicatorSub());
+        std::copy(tmp.begin(), tmp.begin()+nnorms, resnorm0.begin());
+        std::copy(tmp.begin()+nnorms, tmp.end(), rhsnorm0.begin());
     }
 
-    m_init_resnorm0 = resnorm0;
-    m_rhsnorm0 = rhsnorm0;
+    m_init_resnorm0 = *std::max_element(resnorm0.begin(), resnorm0.end());
+    m_rhsnorm0 = *std::max_element(rhsnorm0.begin(), rhsnorm0.end());
 
-    Real max_norm;
+    if (!is_nsolve && verbose >= 1)
+    {
+        amrex::Print() << "MLMG: Initial rhs               = " << m_rhsnorm0 << "\n"
+                       << "MLMG: Initial residual (resid0) = " << m_init_resnorm0 << "\n";
+    }
+
+    Vector<Real> max_norm(nnorms);
+    Vector<Real> res_target(nnorms);
     std::string norm_name;
-    if (always_use_bnorm or rhsnorm0 >= resnorm0) {
-        norm_name = "bnorm";
-        max_norm = rhsnorm0;
-    } else {
-        norm_name = "resid0";
-        max_norm = resnorm0;
+    for (int i = 0; i < nnorms; ++i)
+    {
+        if (always_use_bnorm or rhsnorm0[i] >= resnorm0[i]) {
+            norm_name = "bnorm";
+            max_norm[i] = rhsnorm0[i];
+        } else {
+            norm_name = "resid0";
+            max_norm[i] = resnorm0[i];
+        }
+        res_target[i] = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm[i]);
     }
-    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm);
+    if (nnorms > 1) norm_name = "norm";
 
-    if (!is_nsolve && resnorm0 <= res_target) {
-        composite_norminf = resnorm0;
+    // Largest ratio of norms to their targets' base norms.  Without a
+    // batch, this is the plain ratio, as it has always been.
+    auto rel_norm = [&] (Vector<Real> const& norms) -> Real {
+        if (nnorms == 1) return norms[0]/max_norm[0];
+        Real r = 0.0;
+        for (int i = 0; i < nnorms; ++i) {
+            r = std::max(r, (max_norm[i] > 0.0) ? norms[i]/max_norm[i] : norms[i]);
+        }
+        return r;
+    };
+    auto all_converged = [&] (Vector<Real> const& norms) -> bool {
+        for (int i = 0; i < nnorms; ++i) {
+            if (norms[i] > res_target[i]) return false;
+        }
+        return true;
+    };
+    auto any_diverged = [&] (Vector<Real> const& norms) -> bool {
+        for (int i = 0; i < nnorms; ++i) {
+            if (norms[i] > 1.e20*max_norm[i]) return true;
+        }
+        return false;
+    };
+
+    m_final_resnorms = resnorm0;
+    m_niters_rhs.assign(nnorms, 0);
+
+    if (!is_nsolve && all_converged(resnorm0)) {
+        composite_norminf = m_init_resnorm0;
         if (verbose >= 1) {
             amrex::Print() << "MLMG: No iterations needed\n";
         }
@@ -134,48 +173,58 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
             if (is_nsolve) continue;
 
-            Real fine_norminf = ResNormInf(finest_amr_lev);
-            m_iter_fine_resnorm0.push_back(fine_norminf);
-            composite_norminf = fine_norminf;
+            Vector<Real> fine_norminf = ResNormInfs(finest_amr_lev, nnorms);
+            ParallelAllReduce::Max(fine_norminf.data(), nnorms, ParallelContext::CommunicatorSub());
+            m_iter_fine_resnorm0.push_back(*std::max_element(fine_norminf.begin(), fine_norminf.end()));
+            m_final_resnorms = fine_norminf;
+            for (int i = 0; i < nnorms; ++i) {
+                if (m_niters_rhs[i] == 0 && fine_norminf[i] <= res_target[i]) {
+                    m_niters_rhs[i] = iter+1;
+                }
+            }
             if (verbose >= 2) {
                 amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1 << " Fine resid/"
-                               << norm_name << " = " << fine_norminf/max_norm << "\n";
+                               << norm_name << " = " << rel_norm(fine_norminf) << "\n";
             }
-            bool fine_converged = (fine_norminf <= res_target);
+            bool fine_converged = all_converged(fine_norminf);
 
             if (namrlevs == 1 and fine_converged) {
                 converged = true;
             } else if (fine_converged) {
                 // finest level is converged, but we still need to test the coarse levels
                 computeMLResidual(finest_amr_lev-1);
-                Real crse_norminf = MLResNormInf(finest_amr_lev-1);
+                Vector<Real> crse_norminf = MLResNormInfs(finest_amr_lev-1, nnorms);
+                ParallelAllReduce::Max(crse_norminf.data(), nnorms, ParallelContext::CommunicatorSub());
                 if (verbose >= 2) {
                     amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1
                                    << " Crse resid/" << norm_name << " = "
-                                   << crse_norminf/max_norm << "\n";
+                                   << rel_norm(crse_norminf) << "\n";
+                }
+                converged = all_converged(crse_norminf);
+                for (int i = 0; i < nnorms; ++i) {
+                    m_final_resnorms[i] = std::max(fine_norminf[i], crse_norminf[i]);
                 }
-                converged = (crse_norminf <= res_target);
-                composite_norminf = std::max(fine_norminf, crse_norminf);
             } else {
                 converged = false;
             }
+            composite_norminf = *std::max_element(m_final_resnorms.begin(), m_final_resnorms.end());
 
             if (converged) {
                 if (verbose >= 1) {
                     amrex::Print() << "MLMG: Final Iter. " << iter+1
                                    << " resid, resid/" << norm_name << " = "
                                    << composite_norminf << ", "
-                                   << composite_norminf/max_norm << "\n";
+                                   << rel_norm(m_final_resnorms) << "\n";
                 }
                 break;
             } else {
-              if (composite_norminf > 1.e20*max_norm) 
+              if (any_diverged(m_final_resnorms))
               {
                   if (verbose > 0) {
                       amrex::Print() << "MLMG: Failing to converge after " << iter+1 << " iterations."
                                      << " resid, resid/" << norm_name << " = "
                                      << composite_norminf << ", "
-                                     << composite_norminf/max_norm << "\n";
+                                     << rel_norm(m_final_resnorms) << "\n";
                       amrex::Abort("MLMG failing so lets stop here");
                   }
               }
@@ -187,7 +236,7 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
                 amrex::Print() << "MLMG: Failed to converge after " << max_iters << " iterations."
                                << " resid, resid/" << norm_name << " = "
                                << composite_norminf << ", "
-                               << composite_norminf/max_norm << "\n";
+                               << rel_norm(m_final_resnorms) << "\n";
             }
             amrex::Abort("MLMG failed");
         }
@@ -252,7 +301,7 @@ void MLMG::oneIter (int iter)
             makeSolvable(0,0,res[0][0]);
         }
 
-        if (iter < max_fmg_iters) {
+        if (iter < max_fmg_iters && !use_single) {
             mgFcycle ();
         } else {
             mgVcycle (0, 0);
@@ -425,6 +474,23 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
         std::string blp_mgv_down_lev_str = make_str("MLMG::mgVcycle_down::", mglev);
         BL_PROFILE_VAR(blp_mgv_down_lev_str, blp_mgv_down_lev);
 
+        if (isSingleLevel(mglev))
+        {
+            fcor[amrlev][mglev]->setVal(0.0f);
+            bool skip_fillboundary = true;
+            for (int i = 0; i < nu1; ++i) {
+                linop.smoothSingle(amrlev, mglev, *fcor[amrlev][mglev], *fres[amrlev][mglev],
+                                   skip_fillboundary);
+                skip_fillboundary = false;
+            }
+
+            computeResOfCorrectionSingle(amrlev, mglev);
+
+            linop.restrictionSingle(amrlev, mglev+1, *fres[amrlev][mglev+1],
+                                    *frescor[amrlev][mglev]);
+            continue;
+        }
+
         if (verbose >= 4)
         {
             Real norm = res[amrlev][mglev].norm0();
@@ -453,11 +519,19 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
         // res_crse = R(rescor_fine); this provides res/b to the level below
         linop.restriction(amrlev, mglev+1, res[amrlev][mglev+1], rescor[amrlev][mglev]);
 
+        if (isSingleLevel(mglev+1)) {
+            MLLinOp::convertCopy(*fres[amrlev][mglev+1], res[amrlev][mglev+1], linop.getNComp(), 0);
+        }
     }
 
     BL_PROFILE_VAR("MLMG::mgVcycle_bottom", blp_bottom);
     if (amrlev == 0)
     {
+        if (isSingleLevel(mglev_bottom)) {
+            // The bottom solve is always done in Real.
+            MLLinOp::convertCopy(res[amrlev][mglev_bottom], *fres[amrlev][mglev_bottom],
+                                 linop.getNComp(), 0);
+        }
         if (verbose >= 4)
         {
             Real norm = res[amrlev][mglev_bottom].norm0();
@@ -473,6 +547,20 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev_bottom
                            << "   UP: Norm after  bottom " << norm << "\n";
         }
+        if (isSingleLevel(mglev_bottom)) {
+            MLLinOp::convertCopy(*fcor[amrlev][mglev_bottom], *cor[amrlev][mglev_bottom],
+                                 linop.getNComp(), 0);
+        }
+    }
+    else if (isSingleLevel(mglev_bottom))
+    {
+        fcor[amrlev][mglev_bottom]->setVal(0.0f);
+        bool skip_fillboundary = true;
+        for (int i = 0; i < nu1; ++i) {
+            linop.smoothSingle(amrlev, mglev_bottom, *fcor[amrlev][mglev_bottom],
+                               *fres[amrlev][mglev_bottom], skip_fillboundary);
+            skip_fillboundary = false;
+        }
     }
     else
     {
@@ -503,6 +591,21 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     {
         std::string blp_mgv_up_lev_str = make_str("MLMG::mgVcycle_up::", mglev);
         BL_PROFILE_VAR(blp_mgv_up_lev_str, blp_mgv_up_lev);
+        if (isSingleLevel(mglev))
+        {
+            addInterpCorrectionSingle(amrlev, mglev);
+            for (int i = 0; i < nu2; ++i) {
+                linop.smoothSingle(amrlev, mglev, *fcor[amrlev][mglev], *fres[amrlev][mglev]);
+            }
+            continue;
+        }
+
+        if (isSingleLevel(mglev+1)) {
+            // Bring the single precision correction back for the top MG level
+            MLLinOp::convertCopy(*cor[amrlev][mglev+1], *fcor[amrlev][mglev+1],
+                                 linop.getNComp(), 0);
+        }
+
         // cor_fine += I(cor_crse)
         addInterpCorrection(amrlev, mglev);
         if (verbose >= 4)
@@ -851,6 +954,39 @@ MLMG::addInterpCorrection (int alev, int mglev)
     linop.interpolation(alev, mglev, fine_cor, *cmf);
 }
 
+// Single precision version of addInterpCorrection for MG levels > 0
+void
+MLMG::addInterpCorrectionSingle (int alev, int mglev)
+{
+    BL_PROFILE("MLMG::addInterpCorrectionSingle()");
+
+    const int ncomp = linop.getNComp();
+
+    const FMultiFab& crse_cor = *fcor[alev][mglev+1];
+    FMultiFab&       fine_cor = *fcor[alev][mglev  ];
+
+    FMultiFab cfine;
+    const FMultiFab* cmf;
+
+    if (amrex::isMFIterSafe(crse_cor, fine_cor))
+    {
+        cmf = &crse_cor;
+    }
+    else
+    {
+        BoxArray cba = fine_cor.boxArray();
+        IntVect ratio = (alev > 0) ? IntVect(2) : linop.mg_coarsen_ratio_vec[mglev];
+
+        cba.coarsen(ratio);
+        const int ng = 0;
+        cfine.define(cba, fine_cor.DistributionMap(), ncomp, ng);
+        cfine.ParallelCopy(crse_cor);
+        cmf = &cfine;
+    }
+
+    linop.interpolationSingle(alev, mglev, fine_cor, *cmf);
+}
+
 // Compute rescor = res - L(cor)
 // in   : res
 // inout: cor (out due to FillBoundary in linop.correctionResidual)
@@ -865,6 +1001,15 @@ MLMG::computeResOfCorrection (int amrlev, int mglev)
     linop.correctionResidual(amrlev, mglev, r, x, b, BCMode::Homogeneous);
 }
 
+// Single precision version of computeResOfCorrection for MG levels > 0
+void
+MLMG::computeResOfCorrectionSingle (int amrlev, int mglev)
+{
+    BL_PROFILE("MLMG:computeResOfCorrectionSingle()");
+    linop.correctionResidualSingle(amrlev, mglev, *frescor[amrlev][mglev],
+                                   *fcor[amrlev][mglev], *fres[amrlev][mglev]);
+}
+
 // At the true bottom of the coarset AMR level.
 // in  : Residual (res) as b
 // out : Correction (cor) as x
@@ -947,12 +1092,27 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithPETSc(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::amg)
+        {
+            int ret = bottomSolveWithAMG(x, *bottom_b);
+            // If the AMG solve failed then set the correction to zero
+            if (ret != 0) {
+                cor[amrlev][mglev]->setVal(0.0);
+                for (int i = 0; i < nuf; ++i) {
+                    linop.smooth(amrlev, mglev, x, b);
+                }
+            }
+        }
         else
         {
             MLCGSolver::Type cg_type;
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipecg) {
+                cg_type = MLCGSolver::Type::PipeCG;
+            } else if (bottom_solver == BottomSolver::pipebicgstab) {
+                cg_type = MLCGSolver::Type::PipeBiCGStab;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -1013,9 +1173,17 @@ Real
 MLMG::ResNormInf (int alev, bool local)
 {
     BL_PROFILE("MLMG::ResNormInf()");
+    Real norm = ResNormInfs(alev, 1)[0];
+    if (!local) ParallelAllReduce::Max(norm, ParallelContext::CommunicatorSub());
+    return norm;
+}
+
+Vector<Real>
+MLMG::ResNormInfs (int alev, int nnorms)
+{
     const int ncomp = linop.getNComp();
     const int mglev = 0;
-    Real norm = 0.0;
+    Vector<Real> norm(nnorms, 0.0);
     MultiFab* pmf = &(res[alev][mglev]);
 #ifdef AMREX_USE_EB
     if (linop.isCellCentered() && scratch[alev]) {
@@ -1040,9 +1208,9 @@ MLMG::ResNormInf (int alev, bool local)
 	} else {
             newnorm = pmf->norm0(n,0,true);
 	}
-        norm = std::max(norm, newnorm);
+        Real& norm_n = norm[(nnorms > 1) ? n : 0];
+        norm_n = std::max(norm_n, newnorm);
     }
-    if (!local) ParallelAllReduce::Max(norm, ParallelContext::CommunicatorSub());
     return norm;
 }
 
@@ -1051,12 +1219,22 @@ Real
 MLMG::MLResNormInf (int alevmax, bool local)
 {
     BL_PROFILE("MLMG::MLResNormInf()");
-    Real r = 0.0;
+    Real r = MLResNormInfs(alevmax, 1)[0];
+    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    return r;
+}
+
+Vector<Real>
+MLMG::MLResNormInfs (int alevmax, int nnorms)
+{
+    Vector<Real> r(nnorms, 0.0);
     for (int alev = 0; alev <= alevmax; ++alev)
     {
-        r = std::max(r, ResNormInf(alev,true));
+        const Vector<Real> rlev = ResNormInfs(alev, nnorms);
+        for (int i = 0; i < nnorms; ++i) {
+            r[i] = std::max(r[i], rlev[i]);
+        }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
     return r;
 }
 
@@ -1065,8 +1243,16 @@ Real
 MLMG::MLRhsNormInf (bool local)
 {
     BL_PROFILE("MLMG::MLRhsNormInf()");
+    Real r = MLRhsNormInfs(1)[0];
+    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    return r;
+}
+
+Vector<Real>
+MLMG::MLRhsNormInfs (int nnorms)
+{
     const int ncomp = linop.getNComp();
-    Real r = 0.0;
+    Vector<Real> r(nnorms, 0.0);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
         MultiFab* pmf = &(rhs[alev]);
@@ -1087,14 +1273,14 @@ MLMG::MLRhsNormInf (bool local)
 #endif
         for (int n=0; n<ncomp; ++n)
         {
+            Real& r_n = r[(nnorms > 1) ? n : 0];
             if (alev < finest_amr_lev) {
-                r = std::max(r, pmf->norm0(*fine_mask[alev],n,0,true));
+                r_n = std::max(r_n, pmf->norm0(*fine_mask[alev],n,0,true));
             } else {
-                r = std::max(r, pmf->norm0(n,0,true));
+                r_n = std::max(r_n, pmf->norm0(n,0,true));
             }
         }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
     return r;
 }
 
@@ -1137,15 +1323,25 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     int nghost = 0;
     if (cf_strategy == CFStrategy::ghostnodes) nghost = linop.getNGrow();
 
+    bool linop_changed = false;
     if (!linop_prepared) {
         linop.prepareForSolve();
         linop_prepared = true;
+        linop_changed = true;
     } else if (linop.needsUpdate()) {
         linop.update();
+        linop_changed = true;
 
 #ifdef AMREX_USE_HYPRE
-        hypre_solver.reset();
-        hypre_bndry.reset();
+        if (reuse_hierarchy && hypre_solver && hypre_solver->canUpdateCoeffs())
+        {
+            linop.updateHypre(*hypre_solver);
+        }
+        else
+        {
+            hypre_solver.reset();
+            hypre_bndry.reset();
+        }
         hypre_node_solver.reset();
 #endif
 
@@ -1153,6 +1349,28 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         petsc_solver.reset(); 
         petsc_bndry.reset(); 
 #endif
+
+        if (reuse_hierarchy && amg_solver)
+        {
+            linop.updateAMG(*amg_solver);
+        }
+        else
+        {
+            amg_solver.reset();
+            amg_bndry.reset();
+        }
+    }
+
+    // The native AMG cannot handle cut cells.  Fall back to bicgstab here
+    // rather than abort in the middle of the bottom solve.
+    if (bottom_solver == BottomSolver::amg &&
+        MLAMGSolver::hasCutCells(linop.Factory(0, linop.NMGLevels(0)-1)))
+    {
+        if (ParallelDescriptor::IOProcessor()) {
+            amrex::Warning("MLMG: the amg bottom solver does not support cut cells, "
+                           "using bicgstab instead");
+        }
+        bottom_solver = BottomSolver::bicgstab;
     }
 
     sol.resize(namrlevs);
@@ -1216,19 +1434,41 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         makeSolvable();
     }
 
+    use_single = mixed_precision && linop.isCellCentered()
+        && cf_strategy == CFStrategy::none && linop.supportsMixedPrecision();
+
+    // In mixed precision, the MG levels that run in float do not need
+    // the Real res, rescor and cor, except where noted in needsRealResCor.
+    // They are defined when first needed, in case mixed precision is
+    // turned off later.
     int ng = linop.isCellCentered() ? 0 : 1;
     if (cf_strategy == CFStrategy::ghostnodes) ng = nghost;
-    if (!solve_called) {
-        linop.make(res, ncomp, ng);
-        linop.make(rescor, ncomp, ng);
-    }
+    res.resize(namrlevs);
+    rescor.resize(namrlevs);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
         const int nmglevs = linop.NMGLevels(alev);
+        res[alev].resize(nmglevs);
+        rescor[alev].resize(nmglevs);
         for (int mglev = 0; mglev < nmglevs; ++mglev)
         {
-               res[alev][mglev].setVal(0.0);
-            rescor[alev][mglev].setVal(0.0);
+            const BoxArray& ba = amrex::convert(linop.m_grids[alev][mglev], linop.m_ixtype);
+            const DistributionMapping& dm = linop.m_dmap[alev][mglev];
+            if (needsRealResCor(alev, mglev)) {
+                if (res[alev][mglev].empty()) {
+                    res[alev][mglev].define(ba, dm, ncomp, ng, MFInfo(),
+                                            *linop.Factory(alev,mglev));
+                }
+                res[alev][mglev].setVal(0.0);
+            }
+            // rescor of the bottom is only used to print its norm.
+            if (!isSingleLevel(mglev) || (alev == 0 && mglev == nmglevs-1)) {
+                if (rescor[alev][mglev].empty()) {
+                    rescor[alev][mglev].define(ba, dm, ncomp, ng, MFInfo(),
+                                               *linop.Factory(alev,mglev));
+                }
+                rescor[alev][mglev].setVal(0.0);
+            }
         }
     }
 
@@ -1240,7 +1480,8 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         cor[alev].resize(nmglevs);
         for (int mglev = 0; mglev < nmglevs; ++mglev)
         {
-            if (!solve_called) {
+            if (!needsRealResCor(alev, mglev)) continue;
+            if (cor[alev][mglev] == nullptr) {
                 cor[alev][mglev].reset(new MultiFab(res[alev][mglev].boxArray(),
                                                     res[alev][mglev].DistributionMap(),
                                                     ncomp, ng, MFInfo(),
@@ -1257,7 +1498,10 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         cor_hold[alev].resize(nmglevs);
         for (int mglev = 0; mglev < nmglevs-1; ++mglev)
         {
-            if (!solve_called) {
+            // Only FMG uses them below MG level 0, and it is not done in
+            // mixed precision.
+            if (isSingleLevel(mglev)) continue;
+            if (cor_hold[alev][mglev] == nullptr) {
                 cor_hold[alev][mglev].reset(new MultiFab(cor[alev][mglev]->boxArray(),
                                                          cor[alev][mglev]->DistributionMap(),
                                                          ncomp, ng, MFInfo(),
@@ -1278,6 +1522,8 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         cor_hold[alev][0]->setVal(0.0);
     }
 
+    prepareForMixedPrecision(linop_changed);
+
     buildFineMask();
 
     if (!solve_called)
@@ -1317,6 +1563,70 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     }
 }
 
+bool
+MLMG::needsRealResCor (int alev, int mglev) const noexcept
+{
+    // MG level 1 needs them to change precision after restriction from,
+    // and before interpolation to, MG level 0.  The bottom of AMR level 0
+    // is solved in Real.
+    return !isSingleLevel(mglev) || mglev == 1
+        || (alev == 0 && mglev == linop.NMGLevels(0)-1);
+}
+
+void
+MLMG::prepareForMixedPrecision (bool linop_changed)
+{
+    if (mixed_precision && !use_single && verbose >= 1 && !solve_called) {
+        amrex::Print() << "MLMG: mixed precision is not supported by " << linop.name()
+                       << ", solving in Real\n";
+    }
+
+    if (!use_single) return;
+
+    if (max_fmg_iters > 0 && !solve_called && ParallelDescriptor::IOProcessor()) {
+        amrex::Warning("MLMG: FMG cycles are not supported in mixed precision, "
+                       "using V-cycles instead");
+    }
+
+    if (linop_changed || !single_prepared) {
+        linop.prepareForMixedPrecision();
+        single_prepared = true;
+    }
+
+    const int ncomp = linop.getNComp();
+    if (fcor.size() != namrlevs)
+    {
+        fres.resize(namrlevs);
+        fcor.resize(namrlevs);
+        frescor.resize(namrlevs);
+        for (int alev = 0; alev < namrlevs; ++alev)
+        {
+            const int nmglevs = linop.NMGLevels(alev);
+            fres[alev].resize(nmglevs);
+            fcor[alev].resize(nmglevs);
+            frescor[alev].resize(nmglevs);
+            for (int mglev = 1; mglev < nmglevs; ++mglev)
+            {
+                const BoxArray& ba = linop.m_grids[alev][mglev];
+                const DistributionMapping& dm = linop.m_dmap[alev][mglev];
+                fres[alev][mglev].reset(new FMultiFab(ba, dm, ncomp, 0));
+                fcor[alev][mglev].reset(new FMultiFab(ba, dm, ncomp, 1));
+                frescor[alev][mglev].reset(new FMultiFab(ba, dm, ncomp, 0));
+            }
+        }
+    }
+
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        for (int mglev = 1; mglev < linop.NMGLevels(alev); ++mglev)
+        {
+            fres[alev][mglev]->setVal(0.0f);
+            fcor[alev][mglev]->setVal(0.0f);
+            frescor[alev][mglev]->setVal(0.0f);
+        }
+    }
+}
+
 void
 MLMG::prepareForNSolve ()
 {
@@ -1928,6 +2238,54 @@ MLMG::bottomSolveWithPETSc (MultiFab& x, const MultiFab& b)
 #endif
 }
 
+int
+MLMG::bottomSolveWithAMG (MultiFab& x, const MultiFab& b)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(linop.isCellCentered(),
+                                     "bottomSolveWithAMG only works with cell-centered solvers");
+
+    const int amrlev = 0;
+    const int mglev  = linop.NMGLevels(amrlev) - 1;
+
+    const int ncomp = linop.getNComp();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ncomp == 1 || linop.isBatched(),
+                                     "bottomSolveWithAMG doesn't work with coupled components");
+
+    if (amg_solver == nullptr)
+    {
+        amg_solver = linop.makeAMG();
+        amg_solver->setVerbose(bottom_verbose);
+
+        const BoxArray& ba = linop.m_grids[amrlev].back();
+        const DistributionMapping& dm = linop.m_dmap[amrlev].back();
+        const Geometry& geom = linop.m_geom[amrlev].back();
+
+        amg_bndry.reset(new MLMGBndry(ba, dm, ncomp, geom));
+        amg_bndry->setHomogValues();
+        const Real* dx = linop.m_geom[0][0].CellSize();
+        int crse_ratio = linop.m_coarse_data_crse_ratio > 0 ? linop.m_coarse_data_crse_ratio : 1;
+        RealVect bclocation(AMREX_D_DECL(0.5*dx[0]*crse_ratio,
+                                         0.5*dx[1]*crse_ratio,
+                                         0.5*dx[2]*crse_ratio));
+        amg_bndry->setLOBndryConds(linop.m_lobc, linop.m_hibc, -1, bclocation);
+    }
+
+    int ret = amg_solver->solve(x, b, bottom_reltol, bottom_abstol, bottom_maxiter,
+                                *amg_bndry, linop.getMaxOrder());
+    if (ret != 0 && verbose > 1) {
+        amrex::Print() << "MLMG: Bottom solve failed.\n";
+    }
+    m_niters_cg.push_back(amg_solver->getNumIters());
+
+    // As with hypre, remove the constant a singular problem may have picked up.
+    if (linop.isSingular(amrlev) && linop.getEnforceSingularSolvable())
+    {
+        makeSolvable(amrlev, mglev, x);
+    }
+
+    return ret;
+}
+
 void
 MLMG::checkPoint (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
                   Real a_tol_rel, Real a_tol_abs, const char* a_file_name) const
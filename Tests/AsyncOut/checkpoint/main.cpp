@@ -0,0 +1,110 @@
+//
+// Test of VisMF::AsyncWrite with the background thread started by
+// AsyncOut::Start(), as amr.async_checkpoint does, but amrex.async_out off.
+//
+// A job that blocks until released is submitted first, so the writer
+// thread cannot get to the data before the test says so.  AsyncWrite must
+// return with nothing on disk.  The MultiFab is then overwritten, and after
+// AsyncOut::Finish() the file must hold the data at the time of the call.
+//
+#include <AMReX.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace amrex;
+
+void main_main ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    main_main();
+    amrex::Finalize();
+}
+
+void main_main ()
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+    }
+
+    BoxArray ba(Box(IntVect(0),IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab mf(ba, dm, 2, 1);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.fabbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            a(i,j,k,0) = i + 100*j + 10000*k;
+            a(i,j,k,1) = -a(i,j,k,0);
+        });
+    }
+    MultiFab expected(ba, dm, 2, 0);
+    MultiFab::Copy(expected, mf, 0, 0, 2, 0);
+
+    AMREX_ALWAYS_ASSERT(!AsyncOut::UseAsyncOut());
+    AsyncOut::Start();
+    AMREX_ALWAYS_ASSERT(AsyncOut::Running());
+
+    const std::string dir("async_checkpoint");
+    const std::string name(dir + "/mf");
+    amrex::UtilCreateCleanDirectory(dir, true);
+
+    auto release = std::make_shared<std::atomic<bool> >(false);
+    AsyncOut::Submit([=] ()
+    {
+        while (!release->load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    const Real t0 = amrex::second();
+    VisMF::AsyncWrite(mf, name, true);
+    const Real t1 = amrex::second();
+
+    // Nothing can be on disk yet: the writer is still blocked.
+    bool on_disk = amrex::FileExists(name + "_H") ||
+                   amrex::FileExists(name + "_D_00000");
+    ParallelDescriptor::ReduceBoolOr(on_disk);
+    amrex::Print() << "AsyncWrite returned after " << t1-t0 << " seconds, data on disk: "
+                   << on_disk << "\n";
+    if (on_disk) {
+        amrex::Abort("AsyncOut/checkpoint: AsyncWrite did not return before the data were written");
+    }
+
+    // The write must have taken a snapshot.
+    mf.setVal(-1.0);
+
+    release->store(true);
+    AsyncOut::Finish();
+    ParallelDescriptor::Barrier();
+
+    MultiFab mfin;
+    VisMF::Read(mfin, name);
+    AMREX_ALWAYS_ASSERT(mfin.boxArray() == ba && mfin.nComp() == 2 && mfin.nGrow() == 0);
+
+    MultiFab diff(ba, dm, 2, 0);
+    diff.ParallelCopy(mfin, 0, 0, 2);
+    MultiFab::Subtract(diff, expected, 0, 0, 2, 0);
+    const Real err = std::max(diff.norm0(0), diff.norm0(1));
+    amrex::Print() << "max difference of the data read back: " << err << "\n";
+    if (err != 0.0) {
+        amrex::Abort("AsyncOut/checkpoint: the data read back are wrong");
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Multi-threaded alloc/free benchmark of CArena.
+//
+// Each OpenMP thread does nops allocations, keeping up to nlive blocks
+// alive and freeing the oldest one when the window is full, much like the
+// temporary FArrayBoxes of an MFIter loop.  The request sizes are drawn
+// from minsize to maxsize bytes.  It reports ops/sec (an alloc/free pair
+// counts as one op) for 1, 2, 4, ... threads, with the per-thread caches
+// turned off and on.  Note that a team of one thread is not an active
+// parallel region, so the caches are not used in the one-thread case.
+//
+#include <AMReX.H>
+#include <AMReX_CArena.H>
+#include <AMReX_Utility.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_OpenMP.H>
+
+#include <iomanip>
+
+using namespace amrex;
+
+namespace {
+
+double run (CArena& arena, int nthreads, int nops, int nlive,
+            std::size_t minsize, std::size_t maxsize)
+{
+    double t0 = amrex::second();
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+    {
+        std::vector<void*> live(nlive, nullptr);
+        // A cheap LCG so that threads don't share any state.
+        std::uint64_t seed = 12345 + 977*OpenMP::get_thread_num();
+        for (int i = 0; i < nops; ++i) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            std::size_t nbytes = minsize + (seed >> 33) % (maxsize-minsize+1);
+            void*& p = live[i%nlive];
+            arena.free(p);
+            p = arena.alloc(nbytes);
+            static_cast<char*>(p)[0] = 1;
+        }
+        for (auto p : live) {
+            arena.free(p);
+        }
+    }
+    return static_cast<double>(nops)*nthreads / (amrex::second()-t0);
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int nops = 1000000;
+        int nlive = 4;
+        Long minsize = 4*1024;
+        Long maxsize = 512*1024;
+        int max_threads = OpenMP::get_max_threads();
+        // The caches are off by default, so use 16 MB per thread unless
+        // amrex.carena_thread_cache_max_bytes is given.
+        const std::size_t tc_max_bytes_in = CArena::thread_cache_max_bytes;
+        const std::size_t tc_max_bytes = (tc_max_bytes_in > 0) ? tc_max_bytes_in
+                                                               : std::size_t(16*1024*1024);
+        {
+            ParmParse pp;
+            pp.query("nops", nops);
+            pp.query("nlive", nlive);
+            pp.query("minsize", minsize);
+            pp.query("maxsize", maxsize);
+            pp.query("max_threads", max_threads);
+        }
+        AMREX_ALWAYS_ASSERT(nlive > 0 && minsize > 0 && maxsize >= minsize);
+
+        amrex::Print() << "  threads     no cache (ops/s)   thread cache (ops/s)\n";
+        for (int nthreads = 1; nthreads <= max_threads; nthreads *= 2)
+        {
+            CArena::thread_cache_max_bytes = 0;
+            CArena a0;
+            CArena::thread_cache_max_bytes = tc_max_bytes;
+            CArena a1;
+            CArena::thread_cache_max_bytes = tc_max_bytes_in;
+
+            double r0 = run(a0, nthreads, nops, nlive, minsize, maxsize);
+            double r1 = run(a1, nthreads, nops, nlive, minsize, maxsize);
+
+            amrex::Print() << std::setw(9) << nthreads
+                           << std::setw(21) << r0
+                           << std::setw(23) << r1 << "\n";
+
+            AMREX_ALWAYS_ASSERT(a0.heap_space_actually_used() == 0);
+        }
+    }
+    amrex::Finalize();
+}
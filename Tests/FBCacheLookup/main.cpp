@@ -0,0 +1,74 @@
+//
+// Micro-benchmark of the FillBoundary metadata cache lookup.
+//
+// It builds nmfs MultiFabs, each on its own BoxArray, and caches FB
+// metadata for nvariants ghost cell configurations of each of them.  So
+// there are nmfs*nvariants entries in the FB cache.  Then it times
+// nlookups cache hits in a random order.
+//
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Random.H>
+
+using namespace amrex;
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int nmfs = 1250;
+        int nvariants = 8;
+        int nlookups = 1000000;
+        {
+            ParmParse pp;
+            pp.query("nmfs", nmfs);
+            pp.query("nvariants", nvariants);
+            pp.query("nlookups", nlookups);
+        }
+        nvariants = std::min(nvariants, 8);
+
+        Box domain(IntVect(0), IntVect(7));
+        const Periodicity period(IntVect(AMREX_D_DECL(8,8,8)));
+
+        Vector<IntVect> ngs;
+        for (int i = 0; i < nvariants; ++i) {
+            ngs.push_back(IntVect(AMREX_D_DECL(1+(i&1), 1+((i>>1)&1), 1+((i>>2)&1))));
+        }
+
+        Vector<std::unique_ptr<MultiFab> > mfs;
+        double t0 = amrex::second();
+        for (int i = 0; i < nmfs; ++i) {
+            BoxArray ba(domain);
+            DistributionMapping dm(ba);
+            mfs.emplace_back(new MultiFab(ba, dm, 1, 2));
+            for (auto const& ng : ngs) {
+                mfs.back()->getFB(ng, period);
+            }
+        }
+        double t_build = amrex::second() - t0;
+
+        Vector<int> order(nlookups);
+        for (auto& x : order) {
+            x = amrex::Random_int(nmfs*nvariants);
+        }
+
+        Long nboxes = 0;
+        t0 = amrex::second();
+        for (int x : order) {
+            const auto& fb = mfs[x/nvariants]->getFB(ngs[x%nvariants], period);
+            nboxes += fb.m_LocTags->size();
+        }
+        double t_lookup = amrex::second() - t0;
+
+        ParallelDescriptor::ReduceRealMax(t_build);
+        ParallelDescriptor::ReduceRealMax(t_lookup);
+
+        amrex::Print() << "# of cached FBs: " << nmfs*nvariants << "\n"
+                       << "Build time: " << t_build << " seconds\n"
+                       << "Lookup time: " << t_lookup/nlookups*1.e9 << " ns per lookup"
+                       << " (checksum " << nboxes << ")\n";
+    }
+    amrex::Finalize();
+}
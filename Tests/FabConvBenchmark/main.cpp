@@ -0,0 +1,89 @@
+//
+// Throughput benchmark of RealDescriptor::convertFromNativeFormat and
+// convertToNativeFormat.
+//
+// It converts n native Reals to and from IEEE doubles and floats in
+// native and reversed byte order, nrep times each, and reports the
+// throughput in MB/s of native data.  It also checks that the round trips
+// give back the data, rounded to float for the 32 bit formats.
+//
+#include <AMReX.H>
+#include <AMReX_FabConv.H>
+#include <AMReX_FPC.H>
+#include <AMReX_Utility.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <iomanip>
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+RealDescriptor reversed (const RealDescriptor& rd)
+{
+    Vector<int> ord(rd.orderarray().rbegin(), rd.orderarray().rend());
+    return RealDescriptor(rd.format(), ord.dataPtr(), ord.size());
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Long n = 16*1024*1024;
+        int nrep = 10;
+        {
+            ParmParse pp;
+            pp.query("n", n);
+            pp.query("nrep", nrep);
+        }
+
+        Vector<Real> data(n), back(n);
+        for (Long i = 0; i < n; ++i) {
+            data[i] = std::sin(0.001*i) * std::pow(10.0, (i%61) - 30);
+        }
+        std::unique_ptr<char[]> buf(new char[n*sizeof(double)]);
+
+        const RealDescriptor& rd64 = FPC::Native64RealDescriptor();
+        const RealDescriptor& rd32 = FPC::Native32RealDescriptor();
+        struct Case { std::string name; RealDescriptor rd; };
+        Vector<Case> cases{ {"double", rd64}, {"double swapped", reversed(rd64)},
+                            {"float", rd32},  {"float swapped", reversed(rd32)} };
+
+        const double mb = double(n)*sizeof(Real) / (1024.*1024.);
+        amrex::Print() << "  format            from native (MB/s)   to native (MB/s)\n";
+        for (auto const& c : cases)
+        {
+            double t0 = amrex::second();
+            for (int r = 0; r < nrep; ++r) {
+                RealDescriptor::convertFromNativeFormat(buf.get(), n, data.dataPtr(), c.rd);
+            }
+            double t1 = amrex::second();
+            for (int r = 0; r < nrep; ++r) {
+                RealDescriptor::convertToNativeFormat(back.dataPtr(), n, buf.get(), c.rd);
+            }
+            double t2 = amrex::second();
+
+            const bool narrow = c.rd.numBytes() < int(sizeof(Real));
+            for (Long i = 0; i < n; ++i) {
+                Real expected = narrow ? Real(static_cast<float>(data[i])) : data[i];
+                if (narrow && std::abs(expected) < std::numeric_limits<float>::min()) {
+                    expected = 0;
+                }
+                if (back[i] != expected) {
+                    amrex::Abort("FabConvBenchmark: round trip failed for " + c.name);
+                }
+            }
+
+            amrex::Print() << "  " << std::left << std::setw(16) << c.name << std::right
+                           << std::setw(21) << mb*nrep/(t1-t0)
+                           << std::setw(19) << mb*nrep/(t2-t1) << "\n";
+        }
+    }
+    amrex::Finalize();
+}
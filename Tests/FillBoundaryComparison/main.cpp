@@ -1,6 +1,7 @@
 #include <AMReX_Utility.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_MultiFab.H>
+#include <AMReX_PersistentFB.H>
 #include <AMReX_ParmParse.H>
 
 #include <algorithm>
@@ -162,6 +163,119 @@ main (int argc, char* argv[])
 	std::cout << "ignore this line " << err << std::endl;
     }
 
+    // Same exchange pattern with persistent handles set up once.
+    {
+	Vector<std::unique_ptr<PersistentFB<FArrayBox> > > fbh(nlevels);
+	for (int lev = 0; lev < nlevels; ++lev) {
+	    fbh[lev].reset(new PersistentFB<FArrayBox>(*mfs[lev]));
+	}
+
+	err = 0.0;
+
+	ParallelDescriptor::Barrier();
+	wt0 = ParallelDescriptor::second();
+
+	for (int iround = 0; iround < nrounds; ++iround) {
+	    for (int c=0; c<2; ++c) {
+		for (int lev = 0; lev < nlevels; ++lev) {
+		    fbh[lev]->start();
+		    fbh[lev]->finish();
+		}
+		for (int lev = nlevels-1; lev >= 0; --lev) {
+		    fbh[lev]->start();
+		    fbh[lev]->finish();
+		}
+	    }
+	    Real e = double(iround+ParallelDescriptor::MyProc());
+	    ParallelDescriptor::ReduceRealMax(e);
+	    err += e;
+	}
+
+	ParallelDescriptor::Barrier();
+	wt1 = ParallelDescriptor::second();
+
+	if (ParallelDescriptor::IOProcessor()) {
+	    std::cout << "Using persistent MPI requests" << std::endl;
+	    std::cout << "----------------------------------------------" << std::endl;
+	    std::cout << "Fill Boundary Time: " << wt1-wt0 << std::endl;
+	    std::cout << "----------------------------------------------" << std::endl;
+	    std::cout << "ignore this line " << err << std::endl;
+	}
+    }
+
+    // All levels at once with one aggregated message per neighbor.
+    {
+	Vector<FabArray<FArrayBox>*> fas;
+	for (int lev = 0; lev < nlevels; ++lev) {
+	    fas.push_back(mfs[lev].get());
+	}
+
+	err = 0.0;
+
+	ParallelDescriptor::Barrier();
+	wt0 = ParallelDescriptor::second();
+
+	for (int iround = 0; iround < nrounds; ++iround) {
+	    for (int c=0; c<4; ++c) {
+		FillBoundary(fas, Periodicity::NonPeriodic());
+	    }
+	    Real e = double(iround+ParallelDescriptor::MyProc());
+	    ParallelDescriptor::ReduceRealMax(e);
+	    err += e;
+	}
+
+	ParallelDescriptor::Barrier();
+	wt1 = ParallelDescriptor::second();
+
+	if (ParallelDescriptor::IOProcessor()) {
+	    std::cout << "Using fused FillBoundary of all levels" << std::endl;
+	    std::cout << "----------------------------------------------" << std::endl;
+	    std::cout << "Fill Boundary Time: " << wt1-wt0 << std::endl;
+	    std::cout << "----------------------------------------------" << std::endl;
+	    std::cout << "ignore this line " << err << std::endl;
+	}
+    }
+
+    // Same exchange pattern with MPI neighborhood collectives.
+    {
+	const bool use_nbr = FabArrayBase::use_neighbor_collectives;
+	FabArrayBase::use_neighbor_collectives = true;
+
+	err = 0.0;
+
+	ParallelDescriptor::Barrier();
+	wt0 = ParallelDescriptor::second();
+
+	for (int iround = 0; iround < nrounds; ++iround) {
+	    for (int c=0; c<2; ++c) {
+		for (int lev = 0; lev < nlevels; ++lev) {
+		    mfs[lev]->FillBoundary_nowait();
+		    mfs[lev]->FillBoundary_finish();
+		}
+		for (int lev = nlevels-1; lev >= 0; --lev) {
+		    mfs[lev]->FillBoundary_nowait();
+		    mfs[lev]->FillBoundary_finish();
+		}
+	    }
+	    Real e = double(iround+ParallelDescriptor::MyProc());
+	    ParallelDescriptor::ReduceRealMax(e);
+	    err += e;
+	}
+
+	ParallelDescriptor::Barrier();
+	wt1 = ParallelDescriptor::second();
+
+	FabArrayBase::use_neighbor_collectives = use_nbr;
+
+	if (ParallelDescriptor::IOProcessor()) {
+	    std::cout << "Using MPI neighborhood collectives" << std::endl;
+	    std::cout << "----------------------------------------------" << std::endl;
+	    std::cout << "Fill Boundary Time: " << wt1-wt0 << std::endl;
+	    std::cout << "----------------------------------------------" << std::endl;
+	    std::cout << "ignore this line " << err << std::endl;
+	}
+    }
+
     //
     // When MPI3 shared memory is used, the dtor of MultiFab calls MPI
     // functions.  Because the scope of mfs is beyond the call to
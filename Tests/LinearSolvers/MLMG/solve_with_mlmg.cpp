@@ -20,6 +20,12 @@ static int linop_maxorder = 2;
 static bool agglomeration = false;
 static bool consolidation = false;
 static int  use_hypre = 0;
+static std::string bottom_solver;
+static bool mixed_precision = false;
+static int batch_size = 1;
+static bool reuse_hierarchy = false;
+static Real mixed_precision_tol = 1.e-8;
+static Real check_tol = 1.e-8;
 }
 
 void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
@@ -44,8 +50,14 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
     pp.query("agglomeration", agglomeration);
     pp.query("consolidation", consolidation);
     pp.query("use_hypre", use_hypre);
+    pp.query("bottom_solver", bottom_solver);
+    pp.query("mixed_precision", mixed_precision);
+    pp.query("batch_size", batch_size);
+    pp.query("reuse_hierarchy", reuse_hierarchy);
     pp.query("tol_rel", tol_rel);
     pp.query("tol_abs", tol_abs);
+    pp.query("mixed_precision_tol", mixed_precision_tol);
+    pp.query("check_tol", check_tol);
   }
 
   LPInfo info;
@@ -55,19 +67,53 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
 
   const int nlevels = geom.size();
 
+  BottomSolver bottom = BottomSolver::Default;
+  if (bottom_solver == "bicgstab") {
+    bottom = BottomSolver::bicgstab;
+  } else if (bottom_solver == "cg") {
+    bottom = BottomSolver::cg;
+  } else if (bottom_solver == "pipebicgstab") {
+    bottom = BottomSolver::pipebicgstab;
+  } else if (bottom_solver == "pipecg") {
+    bottom = BottomSolver::pipecg;
+  } else if (bottom_solver == "smoother") {
+    bottom = BottomSolver::smoother;
+  } else if (bottom_solver == "amg") {
+    bottom = BottomSolver::amg;
+  } else if (!bottom_solver.empty()) {
+    amrex::Abort("unknown bottom_solver " + bottom_solver);
+  }
+
   if (composite_solve) {
     Vector<BoxArray> grids;
     Vector<DistributionMapping> dmap;
     Vector<MultiFab*> psoln;
     Vector<MultiFab const*> prhs;
+    // With batch_size > 1, component n of the batch solves the problem
+    // with the rhs and boundary values scaled by n+1.
+    Vector<MultiFab> bsoln(nlevels);
+    Vector<MultiFab> brhs(nlevels);
     for (int ilev = 0; ilev < nlevels; ++ilev) {
       grids.push_back(soln[ilev].boxArray());
       dmap.push_back(soln[ilev].DistributionMap());
-      psoln.push_back(&(soln[ilev]));
-      prhs.push_back(&(rhs[ilev]));
+      if (batch_size > 1) {
+        bsoln[ilev].define(grids[ilev], dmap[ilev], batch_size, soln[ilev].nGrow());
+        brhs[ilev].define(grids[ilev], dmap[ilev], batch_size, 0);
+        for (int n = 0; n < batch_size; ++n) {
+          MultiFab::Copy(bsoln[ilev], soln[ilev], 0, n, 1, soln[ilev].nGrow());
+          bsoln[ilev].mult(Real(n+1), n, 1, soln[ilev].nGrow());
+          MultiFab::Copy(brhs[ilev], rhs[ilev], 0, n, 1, 0);
+          brhs[ilev].mult(Real(n+1), n, 1, 0);
+        }
+        psoln.push_back(&(bsoln[ilev]));
+        prhs.push_back(&(brhs[ilev]));
+      } else {
+        psoln.push_back(&(soln[ilev]));
+        prhs.push_back(&(rhs[ilev]));
+      }
     }
 
-    MLABecLaplacian mlabec(geom, grids, dmap, info);
+    MLABecLaplacian mlabec(geom, grids, dmap, info, {}, batch_size);
     mlabec.setMaxOrder(linop_maxorder);
     // BC
     mlabec.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
@@ -92,11 +138,135 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
     MLMG mlmg(mlabec);
     mlmg.setMaxIter(max_iter);
     mlmg.setMaxFmgIter(max_fmg_iter);
+    mlmg.setBottomSolver(bottom);
     if (use_hypre) mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
     mlmg.setVerbose(verbose);
     mlmg.setBottomVerbose(bottom_verbose);
+    mlmg.setMixedPrecision(mixed_precision);
+    mlmg.setReuseHierarchy(reuse_hierarchy);
+
+    // Keep the initial guess, with the boundary values in its ghost cells.
+    Vector<MultiFab> soln_init(nlevels);
+    if (mixed_precision) {
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        const int ncomp = psoln[ilev]->nComp();
+        const int ng = psoln[ilev]->nGrow();
+        soln_init[ilev].define(grids[ilev], dmap[ilev], ncomp, ng);
+        MultiFab::Copy(soln_init[ilev], *psoln[ilev], 0, 0, ncomp, ng);
+      }
+    }
 
     mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+
+    if (mixed_precision) {
+      // Solve again in double precision from the same initial guess.  The
+      // two solutions must agree to within mixed_precision_tol relative to
+      // the size of the solution.
+      MLMG mlmg_double(mlabec);
+      mlmg_double.setMaxIter(max_iter);
+      mlmg_double.setMaxFmgIter(max_fmg_iter);
+      mlmg_double.setBottomSolver(bottom);
+      mlmg_double.setVerbose(0);
+      Vector<MultiFab*> psoln_double;
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        psoln_double.push_back(&(soln_init[ilev]));
+      }
+      mlmg_double.solve(psoln_double, prhs, tol_rel, tol_abs);
+
+      Real diff = 0.0;
+      Real norm = 0.0;
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        for (int n = 0; n < psoln[ilev]->nComp(); ++n) {
+          norm = std::max(norm, soln_init[ilev].norm0(n));
+        }
+        MultiFab::Subtract(soln_init[ilev], *psoln[ilev], 0, 0, psoln[ilev]->nComp(), 0);
+        for (int n = 0; n < psoln[ilev]->nComp(); ++n) {
+          diff = std::max(diff, soln_init[ilev].norm0(n));
+        }
+      }
+      amrex::Print() << "Mixed precision: " << mlmg.getNumIters() << " iterations (double: "
+                     << mlmg_double.getNumIters() << "), max |phi - phi_double| = " << diff
+                     << ", max |phi_double| = " << norm << "\n";
+      AMREX_ALWAYS_ASSERT(diff <= mixed_precision_tol * norm);
+    }
+
+    if (reuse_hierarchy) {
+      // Solve again with the same MLMG object after scaling alpha, beta
+      // and the rhs by 2.  The solution must not change, and the new
+      // coefficients must reach the bottom solver: with stale ones, it
+      // would take many more iterations.
+      AMREX_ALWAYS_ASSERT(batch_size == 1);
+      const Real scale = 2.0;
+      const int niters = mlmg.getNumIters();
+      Vector<MultiFab> soln0(nlevels);
+      Vector<MultiFab> rhs2(nlevels);
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        soln0[ilev].define(grids[ilev], dmap[ilev], 1, 0);
+        MultiFab::Copy(soln0[ilev], soln[ilev], 0, 0, 1, 0);
+        soln[ilev].setVal(0.0, 0, 1, 0);
+        rhs2[ilev].define(grids[ilev], dmap[ilev], 1, 0);
+        MultiFab::Copy(rhs2[ilev], rhs[ilev], 0, 0, 1, 0);
+        rhs2[ilev].mult(scale);
+
+        MultiFab acoef(alpha[ilev].boxArray(), alpha[ilev].DistributionMap(), 1, 0);
+        MultiFab::Copy(acoef, alpha[ilev], 0, 0, 1, 0);
+        acoef.mult(scale);
+        mlabec.setACoeffs(ilev, acoef);
+        std::array<MultiFab, AMREX_SPACEDIM> bcoefs;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+          const BoxArray& ba = amrex::convert(beta[ilev].boxArray(),
+                                              IntVect::TheDimensionVector(idim));
+          bcoefs[idim].define(ba, beta[ilev].DistributionMap(), 1, 0);
+        }
+        amrex::average_cellcenter_to_face(amrex::GetArrOfPtrs(bcoefs),
+                                          beta[ilev], geom[ilev]);
+        for (auto& mf : bcoefs) {
+          mf.mult(scale);
+        }
+        mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoefs));
+      }
+
+      mlmg.solve(psoln, GetVecOfConstPtrs(rhs2), tol_rel, tol_abs);
+
+      Real diff = 0.0;
+      Real norm = 0.0;
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        norm = std::max(norm, soln0[ilev].norm0());
+        MultiFab::Subtract(soln0[ilev], soln[ilev], 0, 0, 1, 0);
+        diff = std::max(diff, soln0[ilev].norm0());
+      }
+      amrex::Print() << "Reuse solve: " << mlmg.getNumIters() << " iterations (first solve: "
+                     << niters << "), max |phi - phi_0| = " << diff << "\n";
+      if (mlmg.getNumIters() > niters + 1) {
+        amrex::Abort("The solve with reused setup took too many iterations");
+      }
+      AMREX_ALWAYS_ASSERT(diff <= check_tol * norm);
+    }
+
+    if (batch_size > 1) {
+      // Every right-hand side must converge, to the same solution up to
+      // its scaling.
+      const auto& niters = mlmg.getNumItersPerRHS();
+      Real norm = 0.0;
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        norm = std::max(norm, bsoln[ilev].norm0(0));
+      }
+      for (int n = 0; n < batch_size; ++n) {
+        Real diff = 0.0;
+        for (int ilev = 0; ilev < nlevels; ++ilev) {
+          MultiFab tmp(grids[ilev], dmap[ilev], 1, 0);
+          MultiFab::LinComb(tmp, 1.0/Real(n+1), bsoln[ilev], n, -1.0, bsoln[ilev], 0, 0, 1, 0);
+          diff = std::max(diff, tmp.norm0());
+        }
+        amrex::Print() << "Batch rhs " << n << ": converged at iteration " << niters[n]
+                       << ", max |phi_n/(n+1) - phi_0| = " << diff << "\n";
+        AMREX_ALWAYS_ASSERT(niters[n] > 0);
+        AMREX_ALWAYS_ASSERT(diff <= check_tol * norm);
+      }
+      for (int ilev = 0; ilev < nlevels; ++ilev) {
+        MultiFab::Copy(soln[ilev], bsoln[ilev], 0, 0, 1, 0);
+      }
+    }
   } else {
     const int levbegin = (fine_leve_solve_only) ? nlevels-1 : 0;
     for (int ilev = 0; ilev < levbegin; ++ilev) {
@@ -135,8 +305,10 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
       MLMG mlmg(mlabec);
       mlmg.setMaxIter(max_iter);
       mlmg.setMaxFmgIter(max_fmg_iter);
+      mlmg.setBottomSolver(bottom);
       mlmg.setVerbose(verbose);
       mlmg.setBottomVerbose(bottom_verbose);
+      mlmg.setMixedPrecision(mixed_precision);
 
       mlmg.solve({&soln[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);
     }
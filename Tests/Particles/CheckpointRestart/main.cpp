@@ -0,0 +1,204 @@
+// Checkpoint a two-level particle container, with and without
+// particles.aggregators, and restart it both on the same grids and on a
+// single level with smaller grids owned by other processes.  Every
+// particle must come back with its attributes, in the grid that owns it.
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleReduce.H>
+
+using namespace amrex;
+
+static constexpr int NSR = 1;
+static constexpr int NSI = 1;
+static constexpr int NAR = 1;
+static constexpr int NAI = 1;
+
+using MyParticleContainer = ParticleContainer<NSR, NSI, NAR, NAI>;
+
+struct TestParams {
+    int ncell;
+    int max_grid_size;
+    int restart_max_grid_size;
+    int nlevs;
+    int nppc;
+    int aggregators;
+};
+
+void InitParticles (MyParticleContainer& pc, int nppc)
+{
+    const int lev = 0;
+    const auto dx = pc.Geom(lev).CellSizeArray();
+    const auto plo = pc.Geom(lev).ProbLoArray();
+
+    for (MFIter mfi = pc.MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        const Box& tile_box = mfi.tilebox();
+
+        Gpu::HostVector<MyParticleContainer::ParticleType> host_particles;
+        Gpu::HostVector<ParticleReal> host_real;
+        Gpu::HostVector<int> host_int;
+
+        for (IntVect iv = tile_box.smallEnd(); iv <= tile_box.bigEnd(); tile_box.next(iv))
+        {
+            for (int i_part = 0; i_part < nppc; ++i_part)
+            {
+                MyParticleContainer::ParticleType p;
+                p.id()  = MyParticleContainer::ParticleType::NextID();
+                p.cpu() = ParallelDescriptor::MyProc();
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    p.pos(idim) = plo[idim] + (iv[idim] + (i_part+0.5)/nppc)*dx[idim];
+                }
+                p.rdata(0) = p.id();
+                p.idata(0) = p.id();
+
+                host_particles.push_back(p);
+                host_real.push_back(2*p.id());
+                host_int.push_back(-p.id());
+            }
+        }
+
+        auto& ptile = pc.DefineAndReturnParticleTile(lev, mfi.index(), mfi.LocalTileIndex());
+        auto old_size = ptile.GetArrayOfStructs().size();
+        ptile.resize(old_size + host_particles.size());
+
+        Gpu::copy(Gpu::hostToDevice, host_particles.begin(), host_particles.end(),
+                  ptile.GetArrayOfStructs().begin() + old_size);
+        Gpu::copy(Gpu::hostToDevice, host_real.begin(), host_real.end(),
+                  ptile.GetStructOfArrays().GetRealData(0).begin() + old_size);
+        Gpu::copy(Gpu::hostToDevice, host_int.begin(), host_int.end(),
+                  ptile.GetStructOfArrays().GetIntData(0).begin() + old_size);
+
+        Gpu::synchronize();
+    }
+
+    pc.Redistribute();
+}
+
+// Number of particles, sum of their ids, and number of particles whose
+// attributes do not match their id.
+std::array<Long,3> Summarize (const MyParticleContainer& pc)
+{
+    using PType = MyParticleContainer::SuperParticleType;
+
+    std::array<Long,3> r;
+    r[0] = pc.TotalNumberOfParticles(true, true);
+    r[1] = amrex::ReduceSum(pc, [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Long
+    {
+        return p.id();
+    });
+    r[2] = amrex::ReduceSum(pc, [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Long
+    {
+        return (p.rdata(0) != p.id() || p.rdata(1) != 2*p.id() ||
+                p.idata(0) != p.id() || p.idata(1) != -p.id()) ? 1 : 0;
+    });
+    ParallelDescriptor::ReduceLongSum(r.data(), 3);
+    return r;
+}
+
+void CheckRestart (const MyParticleContainer& pc, const std::array<Long,3>& ref,
+                   const std::string& what)
+{
+    const auto r = Summarize(pc);
+    amrex::Print() << what << ": " << r[0] << " particles\n";
+    AMREX_ALWAYS_ASSERT(r[0] == ref[0]);
+    AMREX_ALWAYS_ASSERT(r[1] == ref[1]);
+    AMREX_ALWAYS_ASSERT(r[2] == 0);
+    AMREX_ALWAYS_ASSERT(pc.OK());
+}
+
+void test_checkpoint_restart (const TestParams& parms)
+{
+    const int nlevs = parms.nlevs;
+
+    RealBox real_box({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+
+    const Box domain(IntVect(0), IntVect(parms.ncell-1));
+
+    Vector<IntVect> rr(nlevs-1, IntVect(2));
+
+    Vector<Geometry> geom(nlevs);
+    geom[0].define(domain, real_box, CoordSys::cartesian, is_per);
+    for (int lev = 1; lev < nlevs; ++lev) {
+        geom[lev].define(amrex::refine(geom[lev-1].Domain(), rr[lev-1]),
+                         real_box, CoordSys::cartesian, is_per);
+    }
+
+    // Each finer level covers the middle half of the one below.
+    Vector<BoxArray> ba(nlevs);
+    Vector<DistributionMapping> dm(nlevs);
+    Box bx = domain;
+    for (int lev = 0; lev < nlevs; ++lev) {
+        ba[lev].define(bx);
+        ba[lev].maxSize(parms.max_grid_size);
+        dm[lev].define(ba[lev]);
+        bx = amrex::refine(amrex::grow(bx, -bx.length(0)/4), 2);
+    }
+
+    MyParticleContainer pc(geom, dm, ba, rr);
+    InitParticles(pc, parms.nppc);
+
+    const auto ref = Summarize(pc);
+    AMREX_ALWAYS_ASSERT(ref[2] == 0);
+
+    // Restart on one level, with smaller grids, none of them on the
+    // process that owned the same region before.
+    BoxArray ba_new(domain);
+    ba_new.maxSize(parms.restart_max_grid_size);
+    Vector<int> pmap = DistributionMapping(ba_new).ProcessorMap();
+    for (auto& proc : pmap) {
+        proc = (proc + 1) % ParallelDescriptor::NProcs();
+    }
+    DistributionMapping dm_new(std::move(pmap));
+
+    ParmParse pp("particles");
+    for (int nagg : {0, parms.aggregators})
+    {
+        pp.add("aggregators", nagg);
+
+        const std::string dir = "chk_agg" + std::to_string(nagg);
+        amrex::UtilCreateCleanDirectory(dir, true);
+        pc.Checkpoint(dir, "particle0");
+
+        {
+            MyParticleContainer pc_same(geom, dm, ba, rr);
+            pc_same.Restart(dir, "particle0");
+            CheckRestart(pc_same, ref, dir + " on the same grids");
+            for (int lev = 0; lev < nlevs; ++lev) {
+                AMREX_ALWAYS_ASSERT(pc_same.NumberOfParticlesAtLevel(lev) ==
+                                    pc.NumberOfParticlesAtLevel(lev));
+            }
+        }
+
+        {
+            MyParticleContainer pc_new(geom[0], dm_new, ba_new);
+            pc_new.Restart(dir, "particle0");
+            AMREX_ALWAYS_ASSERT(pc_new.finestLevel() == 0);
+            CheckRestart(pc_new, ref, dir + " on new grids");
+        }
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        ParmParse pp;
+
+        TestParams parms;
+        pp.get("ncell", parms.ncell);
+        pp.get("max_grid_size", parms.max_grid_size);
+        pp.get("restart_max_grid_size", parms.restart_max_grid_size);
+        pp.get("nlevs", parms.nlevs);
+        pp.get("nppc", parms.nppc);
+        pp.get("aggregators", parms.aggregators);
+
+        test_checkpoint_restart(parms);
+
+        amrex::Print() << "pass" << std::endl;
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,161 @@
+//
+// Example of writing a plotfile to a PlotFileSink instead of a directory.
+//
+// It writes a two level plotfile into a PlotFileMemorySink, where in situ
+// analysis can use it like PlotFileData, and through a PlotFileStreamSink
+// into a stream that is read back, and checks that both have the data.
+//
+// The stream can also go to a local consumer program.  Start the consumer
+// first, e.g.,
+//
+//   ./main3d.gnu.ex consumer=1 socket=/tmp/plt.sock nstreams=4 &
+//   mpiexec -n 4 ./main3d.gnu.MPI.ex socket=/tmp/plt.sock
+//
+// and it prints what it gets from the streams of the 4 processes.
+//
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
+
+#include <sstream>
+
+using namespace amrex;
+
+namespace {
+
+void consume (std::string const& socket, int nstreams)
+{
+    PlotFileMemorySink plt;
+    if ( ! plt.read(socket, nstreams)) {
+        amrex::Abort("consumer: a stream ended early");
+    }
+
+    amrex::Print() << "time = " << plt.time() << ", finest level = " << plt.finestLevel() << "\n";
+    for (int lev = 0; lev <= plt.finestLevel(); ++lev) {
+        const BoxArray& ba = plt.boxArray(lev);
+        Vector<Real> sum(plt.nComp(), 0.0);
+        for (int gid = 0; gid < ba.size(); ++gid) {
+            const FArrayBox& fab = plt.getFab(lev, gid);
+            for (int n = 0; n < plt.nComp(); ++n) {
+                sum[n] += fab.sum<RunOn::Host>(n);
+            }
+        }
+        amrex::Print() << "level " << lev << ": " << ba.size() << " boxes, "
+                       << ba.numPts() << " cells\n";
+        for (int n = 0; n < plt.nComp(); ++n) {
+            amrex::Print() << "    sum of " << plt.varNames()[n] << " = " << sum[n] << "\n";
+        }
+    }
+}
+
+Real maxDiff (const MultiFab& a, const MultiFab& b)
+{
+    MultiFab diff(a.boxArray(), a.DistributionMap(), a.nComp(), 0);
+    MultiFab::Copy(diff, a, 0, 0, a.nComp(), 0);
+    MultiFab::Subtract(diff, b, 0, 0, a.nComp(), 0);
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, diff.norm0(n));
+    }
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        int consumer = 0;
+        int nstreams = 1;
+        std::string socket;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("consumer", consumer);
+            pp.query("nstreams", nstreams);
+            pp.query("socket", socket);
+        }
+
+        if (consumer) {
+            consume(socket, nstreams);
+        } else {
+            const int nlevels = 2;
+            const int ncomp = 2;
+            Vector<IntVect> ref_ratio(nlevels-1, IntVect(2));
+            Vector<Geometry> geom(nlevels);
+            Vector<MultiFab> mf(nlevels);
+
+            RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+            Box domain(IntVect(0), IntVect(n_cell-1));
+            for (int lev = 0; lev < nlevels; ++lev) {
+                geom[lev].define(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+                BoxArray ba(lev == 0 ? domain : amrex::grow(domain, -n_cell/2));
+                ba.maxSize(max_grid_size);
+                // ---- with ghost cells that the sink does not get
+                mf[lev].define(ba, DistributionMapping(ba), ncomp, 1);
+                mf[lev].setVal(-1.0);
+                for (MFIter mfi(mf[lev]); mfi.isValid(); ++mfi) {
+                    const Box& bx = mfi.validbox();
+                    auto const& a = mf[lev].array(mfi);
+                    amrex::ParallelFor(bx, ncomp,
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+                    {
+                        a(i,j,k,n) = (n+1) * (i + 2*j + 3*k) + lev;
+                    });
+                }
+                domain.refine(ref_ratio[0]);
+            }
+
+            Vector<const MultiFab*> mfp{&mf[0], &mf[1]};
+            Vector<std::string> varnames{"a", "b"};
+            Vector<int> level_steps(nlevels, 7);
+            const Real time = 1.5;
+
+            // ---- in memory, each process has its own FABs
+            PlotFileMemorySink mem;
+            WriteMultiLevelPlotfile(mem, nlevels, mfp, varnames, geom, time,
+                                    level_steps, ref_ratio);
+            AMREX_ALWAYS_ASSERT(mem.complete() && mem.finestLevel() == nlevels-1 &&
+                                mem.time() == time && mem.varNames() == varnames);
+
+            // ---- through a stream, which only has the header on the IO process
+            std::stringstream ss;
+            {
+                PlotFileStreamSink stream(ss);
+                WriteMultiLevelPlotfile(stream, nlevels, mfp, varnames, geom, time,
+                                        level_steps, ref_ratio);
+            }
+            PlotFileMemorySink back;
+            back.header(mem.headerText());
+            for (int lev = 0; lev < nlevels; ++lev) {
+                back.level(lev, mem.boxArray(lev), mem.DistributionMap(lev), ncomp);
+            }
+            AMREX_ALWAYS_ASSERT(back.read(ss));
+
+            for (int lev = 0; lev < nlevels; ++lev) {
+                Real err = std::max(maxDiff(mf[lev], mem.get(lev)),
+                                    maxDiff(mf[lev], back.get(lev)));
+                MultiFab b = back.get(lev, "b");
+                MultiFab::Subtract(b, mf[lev], 1, 0, 1, 0);
+                err = std::max(err, b.norm0());
+                amrex::Print() << "level " << lev << ": max difference " << err << "\n";
+                if (err != 0.0) {
+                    amrex::Abort("PlotFileSink: the data are wrong");
+                }
+            }
+
+            if ( ! socket.empty()) {
+                PlotFileStreamSink sink(socket);
+                WriteMultiLevelPlotfile(sink, nlevels, mfp, varnames, geom, time,
+                                        level_steps, ref_ratio);
+            }
+        }
+    }
+    amrex::Finalize();
+}
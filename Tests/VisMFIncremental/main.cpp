@@ -0,0 +1,152 @@
+//
+// Test of VisMF::WriteIncremental.
+//
+// It writes a reference MultiFab, changes some of its FABs, and writes it
+// twice more, each time relative to the previous one.  The headers of the
+// incremental writes must refer to the older files for the unchanged FABs,
+// and reading each of them back must give the data at the time it was
+// written.
+//
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+// Add v to the FABs whose index modulo m is r.
+void change (MultiFab& mf, int m, int r, Real v)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        if (mfi.index() % m == r) {
+            mf[mfi].plus<RunOn::Host>(v);
+        }
+    }
+}
+
+void check (const MultiFab& expected, const std::string& name)
+{
+    MultiFab mf;
+    VisMF::Read(mf, name);
+    AMREX_ALWAYS_ASSERT(mf.boxArray() == expected.boxArray() &&
+                        mf.nComp() == expected.nComp());
+
+    MultiFab diff(expected.boxArray(), expected.DistributionMap(), expected.nComp(), 0);
+    diff.ParallelCopy(mf, 0, 0, expected.nComp());
+    MultiFab::Subtract(diff, expected, 0, 0, expected.nComp(), 0);
+    Real err = 0.0;
+    for (int n = 0; n < expected.nComp(); ++n) {
+        err = std::max(err, diff.norm0(n));
+    }
+    amrex::Print() << name << ": max difference " << err << "\n";
+    if (err != 0.0) {
+        amrex::Abort("VisMFIncremental: the data read back are wrong");
+    }
+}
+
+// Number of times str appears in the header of name.
+int countInHeader (const std::string& name, const std::string& str)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(name + "_H", buf);
+    const std::string hdr(buf.dataPtr());
+    int n = 0;
+    for (auto pos = hdr.find(str); pos != std::string::npos; pos = hdr.find(str, pos+1)) {
+        ++n;
+    }
+    return n;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        const int nboxes = ba.size();
+        AMREX_ALWAYS_ASSERT(nboxes >= 4);
+
+        const int ncomp = 2;
+        MultiFab mf(ba, DistributionMapping(ba), ncomp, 1);
+        mf.setVal(-1.0);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            auto const& a = mf.array(mfi);
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                a(i,j,k,n) = (n+1) * (i + 2*j + 3*k);
+            });
+        }
+
+        const Vector<std::string> dirs{"vismf_inc_0", "vismf_inc_1", "vismf_inc_2",
+                                       "vismf_inc_3"};
+        for (auto const& d : dirs) {
+            UtilCreateCleanDirectory(d, true);
+        }
+        const std::string name0 = dirs[0] + "/Cell";
+        const std::string name1 = dirs[1] + "/Cell";
+        const std::string name2 = dirs[2] + "/Cell";
+        const std::string name3 = dirs[3] + "/Cell";
+
+        // ---- full write
+        MultiFab mf0(ba, mf.DistributionMap(), ncomp, 0);
+        MultiFab::Copy(mf0, mf, 0, 0, ncomp, 0);
+        VisMF::WriteIncremental(mf, name0, std::string());
+
+        // ---- every third FAB changed, relative to the full write
+        change(mf, 3, 0, 10.0);
+        MultiFab mf1(ba, mf.DistributionMap(), ncomp, 0);
+        MultiFab::Copy(mf1, mf, 0, 0, ncomp, 0);
+        VisMF::WriteIncremental(mf, name1, name0);
+
+        // ---- FAB 1, which is unchanged in name1, changed, relative to the
+        //      incremental write.  The references must be to the files
+        //      that hold the data.
+        change(mf, nboxes, 1, 100.0);
+        VisMF::WriteIncremental(mf, name2, name1);
+
+        ParallelDescriptor::Barrier();
+
+        const int nchanged1 = (nboxes+2)/3;
+        const int nchanged2 = 1;
+        const int nref0_in_1 = countInHeader(name1, dirs[0] + "/");
+        const int nref0_in_2 = countInHeader(name2, dirs[0] + "/");
+        const int nref1_in_2 = countInHeader(name2, dirs[1] + "/");
+        amrex::Print() << nboxes << " FABs; " << dirs[1] << " refers to " << dirs[0]
+                       << " for " << nref0_in_1 << " FABs; " << dirs[2] << " refers to "
+                       << dirs[0] << " for " << nref0_in_2 << " and to " << dirs[1]
+                       << " for " << nref1_in_2 << " FABs\n";
+        AMREX_ALWAYS_ASSERT(nref0_in_1 == nboxes - nchanged1);
+        AMREX_ALWAYS_ASSERT(nref0_in_2 == nboxes - nchanged1 - nchanged2);
+        AMREX_ALWAYS_ASSERT(nref1_in_2 == nchanged1);
+
+        check(mf0, name0);
+        check(mf1, name1);
+        check(mf, name2);
+
+        // ---- nothing changed: every FAB refers to older files
+        VisMF::WriteIncremental(mf, name3, name2);
+        ParallelDescriptor::Barrier();
+        AMREX_ALWAYS_ASSERT(countInHeader(name3, "../") == nboxes);
+        AMREX_ALWAYS_ASSERT( ! FileExists(name3 + "_D_00000"));
+        check(mf, name3);
+    }
+    amrex::Finalize();
+}